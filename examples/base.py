@@ -69,10 +69,24 @@ def send_package(apdu_hex, network_type, data_hex=None):
         print("PublicKey [" + str(result[41]) + "] " + result[42:74].hex().upper())
     elif apdu_hex == APDU_GET_APP_CONFIGURATION:
         print('App-Nem Version: {:d}.{:d}.{:d}'.format(result[1],result[2],result[3]))
+        if len(result) > 5:
+            print('Flags: {:02x} - Preferred chunk size: {:d}'.format(result[0], result[4]))
+            for tag, value in parse_capabilities(result[5:]):
+                print('Capability {:02x}: {}'.format(tag, value.hex().upper()))
     else:
         print("Signature: " + result.hex().upper())
     return result
 
+def parse_capabilities(data):
+    # data = version, then (tag, length, value) entries
+    entries = []
+    offset = 1
+    while offset + 2 <= len(data):
+        tag, length = data[offset], data[offset + 1]
+        entries.append((tag, data[offset + 2:offset + 2 + length]))
+        offset += 2 + length
+    return entries
+
 def get_version():
     return send_package(APDU_GET_APP_CONFIGURATION, TESTNET)
 
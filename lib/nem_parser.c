@@ -0,0 +1,75 @@
+/*******************************************************************************
+*   NEM Wallet
+*   (c) 2020 FDS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+#include <string.h>
+#include "nem_parser.h"
+#include "nem/parse/nem_parse.h"
+#include "nem/format/format.h"
+#include "nem/format/printers.h"
+
+static int parse(parse_context_t *context, const uint8_t *data, uint32_t length, uint8_t networkType) {
+    // Same limit as the APDU handler
+    if (length > MAX_RAW_TX) {
+        return E_INVALID_DATA;
+    }
+    memset(context, 0, sizeof(parse_context_t));
+    // The parser does not write to the transaction
+    context->data = (uint8_t *) data;
+    context->length = length;
+    context->networkType = networkType;
+    return parse_txn_context(context);
+}
+
+int nem_parser_validate(const uint8_t *data, uint32_t length, uint8_t networkType, uint32_t *signDataLength) {
+    parse_context_t context;
+    int err = parse(&context, data, length, networkType);
+    if (err == E_SUCCESS && signDataLength != NULL) {
+        *signDataLength = context.signDataLength;
+    }
+    return err;
+}
+
+int nem_parser_parse(const uint8_t *data, uint32_t length, uint8_t networkType, nem_parser_result_t *result) {
+    parse_context_t context;
+    int err = parse(&context, data, length, networkType);
+    if (err != E_SUCCESS) {
+        return err;
+    }
+    result->transactionType = context.transactionType;
+    result->signDataLength = context.signDataLength;
+    result->numFields = context.result.numFields;
+    for (uint8_t i = 0; i < context.result.numFields; i++) {
+        const field_t *field = &context.result.fields[i];
+        resolve_fieldname(field, result->fields[i].name);
+        format_field(&context.result, field, result->fields[i].value);
+    }
+    return E_SUCCESS;
+}
+
+const char *nem_parser_error(int error) {
+    switch (error) {
+        case E_SUCCESS:
+            return "success";
+        case E_NOT_ENOUGH_DATA:
+            return "not enough data";
+        case E_INVALID_DATA:
+            return "invalid data";
+        case E_TOO_MANY_FIELDS:
+            return "too many fields";
+        default:
+            return "unknown error";
+    }
+}
@@ -0,0 +1,51 @@
+/*******************************************************************************
+*   NEM Wallet
+*   (c) 2020 FDS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+#ifndef LEDGER_APP_NEM_NEMPARSER_H
+#define LEDGER_APP_NEM_NEMPARSER_H
+
+// Host library running the transaction parser and formatter of the application.
+// Functions only use the memory given by the caller and can be called
+// concurrently from any number of threads.
+
+#include <stdint.h>
+#include "limitations.h"
+
+typedef struct nem_parser_field_t {
+    char name[MAX_FIELDNAME_LEN];
+    char value[MAX_FIELD_LEN];
+} nem_parser_field_t;
+
+typedef struct nem_parser_result_t {
+    uint32_t transactionType;
+    // Number of bytes signed by the device from the start of the transaction
+    uint32_t signDataLength;
+    uint8_t numFields;
+    // Fields as displayed by the device, public keys are shown in hexadecimal
+    nem_parser_field_t fields[MAX_FIELD_COUNT];
+} nem_parser_result_t;
+
+// Check that the device accepts the transaction, without formatting its fields.
+// networkType is the network of the signing account (MAINNET, TESTNET...).
+// Returns 0 or one of the negative errors of printers.h, signDataLength may be NULL.
+int nem_parser_validate(const uint8_t *data, uint32_t length, uint8_t networkType, uint32_t *signDataLength);
+
+// Parse and format the fields of the transaction, returns 0 or one of the negative errors of printers.h
+int nem_parser_parse(const uint8_t *data, uint32_t length, uint8_t networkType, nem_parser_result_t *result);
+
+const char *nem_parser_error(int error);
+
+#endif //LEDGER_APP_NEM_NEMPARSER_H
@@ -23,15 +23,57 @@
 #define INS_SIGN 0x04
 #define INS_GET_REMOTE_ACCOUNT 0x05
 #define INS_GET_APP_CONFIGURATION 0x06
+// Only with MOSAIC_METADATA_KEY
+#define INS_PROVIDE_MOSAIC_METADATA 0x07
+#define INS_ADD_CONTACT 0x08
+#define INS_SET_APPROVAL_POLICY 0x09
+// Only with HAVE_PERF_COUNTERS
+#define INS_GET_PERF_COUNTERS 0x0A
+// Only with HAVE_TRACE
+#define INS_GET_TRACE 0x0B
+// Only with HAVE_STACK_PAINTING
+#define INS_GET_STACK_USAGE 0x0C
 #define P1_CONFIRM 0x01
 #define P1_NON_CONFIRM 0x00
 #define P2_NO_CHAINCODE 0x00
 #define P2_CHAINCODE 0x01
+#define P2_PUBLIC_KEY_ONLY 0x02u
+#define P2_RAW_ADDRESS 0x04u
 #define P1_MASK_ORDER 0x01u
 #define P1_MASK_MORE 0x80u
+#define P1_MASK_WINDOW 0x02u
+#define P2_EXTENDED_SIGNATURE 0x01u
+#define P2_PULL_MESSAGE 0x02u
 #define P2_SECP256K1 0x40u
 #define P2_ED25519 0x80u
 
+// GET_APP_CONFIGURATION flags
+#define APP_FLAG_SUMMARY_REVIEW 0x01u
+#define APP_FLAG_PRE_DERIVE_KEY 0x02u
+#define APP_FLAG_PUBLIC_KEY_CACHE 0x04u
+#define APP_FLAG_APPROVAL_POLICY 0x08u
+
+// GET_APP_CONFIGURATION capabilities (TLV encoded)
+#define APP_CAPABILITIES_VERSION 0x01
+#define APP_TAG_MAX_RAW_TX 0x01
+#define APP_TAG_MAX_FIELD_COUNT 0x02
+#define APP_TAG_MAX_FIELD_LEN 0x03
+#define APP_TAG_MAX_APDU_PAYLOAD 0x04
+#define APP_TAG_INSTRUCTIONS 0x05
+#define APP_TAG_FEATURES 0x06
+
+// Optional modes supported by this version of the application
+#define APP_FEATURE_SUMMARY_REVIEW 0x0001u
+#define APP_FEATURE_PRE_DERIVE_KEY 0x0002u
+#define APP_FEATURE_CHUNK_SIZE 0x0004u
+#define APP_FEATURE_PUBLIC_KEY_CACHE 0x0008u
+#define APP_FEATURE_COMPACT_PUBLIC_KEY 0x0010u
+#define APP_FEATURE_EXTENDED_SIGNATURE 0x0020u
+#define APP_FEATURE_PULL_MESSAGE 0x0040u
+#define APP_FEATURE_MOSAIC_METADATA 0x0080u
+#define APP_FEATURE_ADDRESS_BOOK 0x0100u
+#define APP_FEATURE_APPROVAL_POLICY 0x0200u
+
 #define OFFSET_CLA 0
 #define OFFSET_INS 1
 #define OFFSET_P1 2
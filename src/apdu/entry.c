@@ -23,11 +23,25 @@
 #include "messages/sign_transaction.h"
 #include "messages/get_remote_account.h"
 #include "messages/get_app_configuration.h"
+#include "messages/provide_mosaic_metadata.h"
+#include "messages/add_contact.h"
+#include "messages/set_approval_policy.h"
+#include "messages/get_perf_counters.h"
+#include "messages/get_trace.h"
+#include "messages/get_stack_usage.h"
+#include "perf.h"
+#include "trace.h"
 
 unsigned char lastINS = 0;
 
 void handle_apdu(volatile unsigned int *flags, volatile unsigned int *tx) {
     unsigned short sw = 0;
+#ifdef HAVE_PERF_COUNTERS
+    perf_set_instruction(G_io_apdu_buffer[OFFSET_INS]);
+#endif
+    PERF_START(PERF_APDU);
+    TRACE(TRACE_APDU, G_io_apdu_buffer[OFFSET_INS] | (G_io_apdu_buffer[OFFSET_P1] << 8u) |
+                      (G_io_apdu_buffer[OFFSET_P2] << 16u), G_io_apdu_buffer[OFFSET_LC]);
 
     BEGIN_TRY {
         TRY {
@@ -55,7 +69,7 @@ void handle_apdu(volatile unsigned int *flags, volatile unsigned int *tx) {
                     handle_sign(G_io_apdu_buffer[OFFSET_P1],
                                G_io_apdu_buffer[OFFSET_P2],
                                G_io_apdu_buffer + OFFSET_CDATA,
-                               G_io_apdu_buffer[OFFSET_LC], flags);
+                               G_io_apdu_buffer[OFFSET_LC], flags, tx);
                     break;
 
                 case INS_GET_REMOTE_ACCOUNT:
@@ -69,6 +83,47 @@ void handle_apdu(volatile unsigned int *flags, volatile unsigned int *tx) {
                     handle_app_configuration(tx);
                     break;
 
+#ifdef MOSAIC_METADATA_KEY
+                case INS_PROVIDE_MOSAIC_METADATA:
+                    handle_provide_mosaic_metadata(G_io_apdu_buffer[OFFSET_P1],
+                                                   G_io_apdu_buffer[OFFSET_P2],
+                                                   G_io_apdu_buffer + OFFSET_CDATA,
+                                                   G_io_apdu_buffer[OFFSET_LC]);
+                    break;
+#endif
+
+                case INS_ADD_CONTACT:
+                    handle_add_contact(G_io_apdu_buffer[OFFSET_P1],
+                                       G_io_apdu_buffer[OFFSET_P2],
+                                       G_io_apdu_buffer + OFFSET_CDATA,
+                                       G_io_apdu_buffer[OFFSET_LC], flags);
+                    break;
+
+                case INS_SET_APPROVAL_POLICY:
+                    handle_set_approval_policy(G_io_apdu_buffer[OFFSET_P1],
+                                               G_io_apdu_buffer[OFFSET_P2],
+                                               G_io_apdu_buffer + OFFSET_CDATA,
+                                               G_io_apdu_buffer[OFFSET_LC], flags);
+                    break;
+
+#ifdef HAVE_PERF_COUNTERS
+                case INS_GET_PERF_COUNTERS:
+                    handle_perf_counters(G_io_apdu_buffer[OFFSET_P1], G_io_apdu_buffer[OFFSET_P2], tx);
+                    break;
+#endif
+
+#ifdef HAVE_TRACE
+                case INS_GET_TRACE:
+                    handle_trace(G_io_apdu_buffer[OFFSET_P1], G_io_apdu_buffer[OFFSET_P2], tx);
+                    break;
+#endif
+
+#ifdef HAVE_STACK_PAINTING
+                case INS_GET_STACK_USAGE:
+                    handle_stack_usage(G_io_apdu_buffer[OFFSET_P1], G_io_apdu_buffer[OFFSET_P2], tx);
+                    break;
+#endif
+
                 default:
                     THROW(0x6D00);
                     break;
@@ -100,4 +155,7 @@ void handle_apdu(volatile unsigned int *flags, volatile unsigned int *tx) {
         }
     }
     END_TRY
+
+    TRACE(TRACE_STATUS, lastINS, sw);
+    PERF_STOP(PERF_APDU);
 }
@@ -17,12 +17,20 @@
 ********************************************************************************/
 #include "global.h"
 #include "messages/sign_transaction.h"
+#include "nem/format/summary.h"
+#include "ui/transaction/review_menu.h"
+
+// Largest globals: the transaction, its parse and pull contexts and the review menu
+#define GLOBALS_RAM_SIZE (sizeof(transaction_context_t) + sizeof(parse_context_t) + sizeof(pull_context_t) + \
+                          MAX_FIELDNAME_LEN + MAX_FIELD_LEN + MAX_REVIEW_STEPS * sizeof(void *) + sizeof(summary_t))
+_Static_assert(GLOBALS_RAM_SIZE <= GLOBALS_RAM_BUDGET, "globals exceed the RAM of the target, see limitations.h");
 
 transaction_context_t transactionContext;
 sign_state_e signState;
 
 void reset_transaction_context() {
     explicit_bzero(&parseContext, sizeof(parse_context_t));
+    explicit_bzero(&pullContext, sizeof(pull_context_t));
     explicit_bzero(&transactionContext, sizeof(transaction_context_t));
     signState = IDLE;
 }
@@ -21,11 +21,14 @@
 #include <stdint.h>
 #include "constants.h"
 #include "limitations.h"
+#include "nem/nem_helpers.h"
 
 typedef enum {
     IDLE,
     WAITING_FOR_MORE,
     PENDING_REVIEW,
+    // Receiving the message of a multisig signature from the host before the review
+    PULLING_MESSAGE,
 } sign_state_e;
 
 typedef struct {
@@ -35,6 +38,11 @@ typedef struct {
     uint32_t bip32Path[MAX_BIP32_PATH];
     uint8_t rawTx[MAX_RAW_TX];
     uint32_t rawTxLength;
+    // Signing key derived ahead of the approval (see settings_t.preDeriveKey), wiped with the context
+    uint8_t keyDerived;
+    uint8_t privateKey[NEM_PRIVATE_KEY_LENGTH];
+    // Append the signer public key and the transaction hash to the signature
+    uint8_t extendedSignature;
 } transaction_context_t;
 
 extern transaction_context_t transactionContext;
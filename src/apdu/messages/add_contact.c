@@ -0,0 +1,89 @@
+/*******************************************************************************
+*   NEM Wallet
+*    (c) 2020 FDS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+#include "add_contact.h"
+#include <os.h>
+#include "base32.h"
+#include "nem/nem_helpers.h"
+#include "ui/main/idle_menu.h"
+#include "ui/address/address_ui.h"
+#include "storage/storage.h"
+
+// Entry waiting for the confirmation of the user
+static address_book_entry_t pendingContact;
+
+static void send_status(uint16_t sw) {
+    G_io_apdu_buffer[0] = sw >> 8u;
+    G_io_apdu_buffer[1] = sw & 0xFFu;
+    // Send back the response, do not restart the event loop
+    io_exchange(CHANNEL_APDU | IO_RETURN_AFTER_TX, 2);
+    // Display back the original UX
+    display_idle_menu();
+}
+
+static void on_contact_approved() {
+    send_status(add_contact((const uint8_t *) pendingContact.address, pendingContact.label) ? 0x9000 : 0x6A84);
+}
+
+static void on_contact_rejected() {
+    send_status(0x6985);
+}
+
+// Base32 address with a valid checksum, for any network
+static bool is_valid_address(const uint8_t *address) {
+    uint8_t rawAddress[NEM_RAW_ADDRESS_LENGTH];
+    uint8_t hash[32];
+    if (base32_decode((const char *) address, NEM_ADDRESS_LENGTH, rawAddress, sizeof(rawAddress)) !=
+        NEM_RAW_ADDRESS_LENGTH) {
+        return false;
+    }
+    sha_calculation(get_algo(rawAddress[0]), rawAddress, NEM_RAW_ADDRESS_LENGTH - 4, hash, sizeof(hash));
+    return memcmp(hash, rawAddress + NEM_RAW_ADDRESS_LENGTH - 4, 4) == 0;
+}
+
+void handle_add_contact(uint8_t p1, uint8_t p2, uint8_t *dataBuffer,
+                        uint16_t dataLength, volatile unsigned int *flags) {
+    if (p1 != 0 || p2 != 0) {
+        THROW(0x6B00);
+    }
+    // data = label length, label, address
+    uint8_t labelLength = dataLength > 0 ? dataBuffer[0] : 0;
+    if (labelLength == 0 || labelLength > MAX_CONTACT_LABEL_LEN ||
+        dataLength != 1 + labelLength + NEM_ADDRESS_LENGTH) {
+        THROW(0x6A80);
+    }
+    const uint8_t *label = dataBuffer + 1;
+    const uint8_t *address = label + labelLength;
+    for (uint8_t i = 0; i < labelLength; i++) {
+        if (label[i] < ' ' || label[i] > '~') {
+            THROW(0x6A80);
+        }
+    }
+    if (!is_valid_address(address)) {
+        THROW(0x6A80);
+    }
+    // Checked before the review so an approved entry is always added
+    if (!can_add_contact(address)) {
+        THROW(0x6A84);
+    }
+
+    memset(&pendingContact, 0, sizeof(address_book_entry_t));
+    memcpy(pendingContact.label, label, labelLength);
+    memcpy(pendingContact.address, address, NEM_ADDRESS_LENGTH);
+    display_contact_confirmation_ui(pendingContact.label, pendingContact.address,
+                                    on_contact_approved, on_contact_rejected);
+    *flags |= IO_ASYNCH_REPLY;
+}
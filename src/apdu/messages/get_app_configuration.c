@@ -17,15 +17,97 @@
 ********************************************************************************/
 #include "get_app_configuration.h"
 #include <os.h>
+#include "apdu/constants.h"
+#include "limitations.h"
+#include "storage/storage.h"
+
+#define MAX_APDU_PAYLOAD MIN(0xFF, IO_APDU_BUFFER_SIZE - OFFSET_CDATA)
+
+static const uint8_t SUPPORTED_INSTRUCTIONS[] = {
+    INS_GET_PUBLIC_KEY,
+    INS_SIGN,
+    INS_GET_REMOTE_ACCOUNT,
+    INS_GET_APP_CONFIGURATION,
+#ifdef MOSAIC_METADATA_KEY
+    INS_PROVIDE_MOSAIC_METADATA,
+#endif
+    INS_ADD_CONTACT,
+    INS_SET_APPROVAL_POLICY,
+#ifdef HAVE_PERF_COUNTERS
+    INS_GET_PERF_COUNTERS,
+#endif
+#ifdef HAVE_TRACE
+    INS_GET_TRACE,
+#endif
+#ifdef HAVE_STACK_PAINTING
+    INS_GET_STACK_USAGE,
+#endif
+};
+
+#ifdef MOSAIC_METADATA_KEY
+#define FEATURE_MOSAIC_METADATA APP_FEATURE_MOSAIC_METADATA
+#else
+#define FEATURE_MOSAIC_METADATA 0
+#endif
+
+static const uint16_t SUPPORTED_FEATURES = APP_FEATURE_SUMMARY_REVIEW |
+                                           APP_FEATURE_PRE_DERIVE_KEY |
+                                           APP_FEATURE_CHUNK_SIZE |
+                                           APP_FEATURE_PUBLIC_KEY_CACHE |
+                                           APP_FEATURE_COMPACT_PUBLIC_KEY |
+                                           APP_FEATURE_EXTENDED_SIGNATURE |
+                                           APP_FEATURE_PULL_MESSAGE |
+                                           FEATURE_MOSAIC_METADATA |
+                                           APP_FEATURE_ADDRESS_BOOK |
+                                           APP_FEATURE_APPROVAL_POLICY;
+
+// Append a big endian integer TLV entry, returns the new response length
+static uint32_t add_uint_tlv(uint32_t tx, uint8_t tag, uint32_t value, uint8_t length) {
+    G_io_apdu_buffer[tx++] = tag;
+    G_io_apdu_buffer[tx++] = length;
+    for (uint8_t i = length; i > 0; i--) {
+        G_io_apdu_buffer[tx++] = (value >> (8u * (i - 1))) & 0xFFu;
+    }
+    return tx;
+}
+
+// Limits and capabilities for hosts to size their requests on the first try
+static uint32_t set_capabilities(uint32_t tx) {
+    G_io_apdu_buffer[tx++] = APP_CAPABILITIES_VERSION;
+    tx = add_uint_tlv(tx, APP_TAG_MAX_RAW_TX, MAX_RAW_TX, sizeof(uint32_t));
+    tx = add_uint_tlv(tx, APP_TAG_MAX_FIELD_COUNT, MAX_FIELD_COUNT, sizeof(uint16_t));
+    tx = add_uint_tlv(tx, APP_TAG_MAX_FIELD_LEN, MAX_FIELD_LEN, sizeof(uint16_t));
+    tx = add_uint_tlv(tx, APP_TAG_MAX_APDU_PAYLOAD, MAX_APDU_PAYLOAD, sizeof(uint16_t));
+    G_io_apdu_buffer[tx++] = APP_TAG_INSTRUCTIONS;
+    G_io_apdu_buffer[tx++] = sizeof(SUPPORTED_INSTRUCTIONS);
+    memcpy(G_io_apdu_buffer + tx, SUPPORTED_INSTRUCTIONS, sizeof(SUPPORTED_INSTRUCTIONS));
+    tx += sizeof(SUPPORTED_INSTRUCTIONS);
+    tx = add_uint_tlv(tx, APP_TAG_FEATURES, SUPPORTED_FEATURES, sizeof(uint16_t));
+    return tx;
+}
 
 /*
 * LEDGER_MAJOR_VERSION, LEDGER_MINOR_VERSION, LEDGER_PATCH_VERSION define in Makefile
 */
 void handle_app_configuration(volatile unsigned int *tx) {
-    G_io_apdu_buffer[0] = 0x00;
+    uint8_t flags = 0x00;
+    if (N_storage.settings.summaryReview) {
+        flags |= APP_FLAG_SUMMARY_REVIEW;
+    }
+    if (N_storage.settings.preDeriveKey) {
+        flags |= APP_FLAG_PRE_DERIVE_KEY;
+    }
+    if (N_storage.settings.publicKeyCache) {
+        flags |= APP_FLAG_PUBLIC_KEY_CACHE;
+    }
+    if (N_storage.policy.enabled) {
+        flags |= APP_FLAG_APPROVAL_POLICY;
+    }
+    G_io_apdu_buffer[0] = flags;
     G_io_apdu_buffer[1] = LEDGER_MAJOR_VERSION;
     G_io_apdu_buffer[2] = LEDGER_MINOR_VERSION;
     G_io_apdu_buffer[3] = LEDGER_PATCH_VERSION;
-    *tx = 4;
+    G_io_apdu_buffer[4] = N_storage.settings.chunkSize;
+    *tx = set_capabilities(5);
     THROW(0x9000);
 }
@@ -0,0 +1,45 @@
+/*******************************************************************************
+*   NEM Wallet
+*    (c) 2020 FDS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+#include "get_perf_counters.h"
+#include <os.h>
+#include "nem/nem_helpers.h"
+#include "perf.h"
+
+#ifdef HAVE_PERF_COUNTERS
+// Returns the counters of the samples since the previous call, then resets them
+void handle_perf_counters(uint8_t p1, uint8_t p2, volatile unsigned int *tx) {
+    uint8_t count;
+    if (p1 != 0 || p2 != 0) {
+        THROW(0x6B00);
+    }
+    const perf_counter_t *counters = get_perf_counters(&count);
+    uint32_t length = write_uint32_be(G_io_apdu_buffer, 0, PERF_TICKS_PER_SECOND);
+    G_io_apdu_buffer[length++] = count;
+    for (uint8_t i = 0; i < count; i++) {
+        const perf_counter_t *counter = &counters[i];
+        G_io_apdu_buffer[length++] = counter->instruction;
+        G_io_apdu_buffer[length++] = counter->phase;
+        length = write_uint32_be(G_io_apdu_buffer, length, counter->count);
+        length = write_uint32_be(G_io_apdu_buffer, length, counter->min);
+        length = write_uint32_be(G_io_apdu_buffer, length, (uint32_t) (counter->total / counter->count));
+        length = write_uint32_be(G_io_apdu_buffer, length, counter->max);
+    }
+    reset_perf_counters();
+    *tx = length;
+    THROW(0x9000);
+}
+#endif
@@ -18,19 +18,30 @@
 #include "get_public_key.h"
 #include "apdu/global.h"
 #include "nem/nem_helpers.h"
+#include "base32.h"
 #include "ui/main/idle_menu.h"
 #include "ui/address/address_ui.h"
+#include "storage/storage.h"
 
 uint8_t nem_publickey[NEM_PUBLIC_KEY_LENGTH];
 char nem_address[NEM_PRETTY_ADDRESS_LENGTH];
+uint8_t nem_rawaddress[NEM_RAW_ADDRESS_LENGTH];
+// P2_PUBLIC_KEY_ONLY / P2_RAW_ADDRESS bits of the pending request
+uint8_t nem_response_format;
 
 uint32_t set_result_get_publickey() {
     uint32_t tx = 0;
 
     //address
-    G_io_apdu_buffer[tx++] = NEM_PRETTY_ADDRESS_LENGTH;
-    memmove(G_io_apdu_buffer + tx, nem_address, NEM_PRETTY_ADDRESS_LENGTH);
-    tx += NEM_PRETTY_ADDRESS_LENGTH;
+    if (nem_response_format & P2_RAW_ADDRESS) {
+        G_io_apdu_buffer[tx++] = NEM_RAW_ADDRESS_LENGTH;
+        memmove(G_io_apdu_buffer + tx, nem_rawaddress, NEM_RAW_ADDRESS_LENGTH);
+        tx += NEM_RAW_ADDRESS_LENGTH;
+    } else if (!(nem_response_format & P2_PUBLIC_KEY_ONLY)) {
+        G_io_apdu_buffer[tx++] = NEM_PRETTY_ADDRESS_LENGTH;
+        memmove(G_io_apdu_buffer + tx, nem_address, NEM_PRETTY_ADDRESS_LENGTH);
+        tx += NEM_PRETTY_ADDRESS_LENGTH;
+    }
 
     //publicKey
     G_io_apdu_buffer[tx++] = NEM_PUBLIC_KEY_LENGTH;
@@ -58,19 +69,45 @@ void on_address_rejected() {
     display_idle_menu();
 }
 
+static void derive_public_key(const uint32_t *bip32Path, uint8_t bip32PathLength, uint8_t algo) {
+    uint8_t privateKeyData[NEM_PRIVATE_KEY_LENGTH];
+    cx_ecfp_private_key_t privateKey;
+    cx_ecfp_public_key_t publicKey;
+
+    io_seproxyhal_io_heartbeat();
+    BEGIN_TRY {
+        TRY {
+            os_perso_derive_node_bip32_seed_key(HDW_ED25519_SLIP10, CX_CURVE_Ed25519, bip32Path, bip32PathLength, privateKeyData, NULL, (unsigned char*) "ed25519-keccak seed", 19);
+            cx_ecfp_init_private_key(CX_CURVE_Ed25519, privateKeyData, NEM_PRIVATE_KEY_LENGTH, &privateKey);
+            io_seproxyhal_io_heartbeat();
+            cx_ecfp_generate_pair2(CX_CURVE_Ed25519, &publicKey, &privateKey, 1, algo);
+            explicit_bzero(&privateKey, sizeof(privateKey));
+            explicit_bzero(privateKeyData, sizeof(privateKeyData));
+            io_seproxyhal_io_heartbeat();
+            nem_public_key(&publicKey, nem_publickey);
+        }
+        CATCH_OTHER(e) {
+            THROW(e);
+        }
+        FINALLY {
+            explicit_bzero(privateKeyData, sizeof(privateKeyData));
+            explicit_bzero(&privateKey, sizeof(privateKey));
+        }
+    }
+    END_TRY
+}
+
 void handle_public_key(uint8_t p1, uint8_t p2, uint8_t *dataBuffer,
                         uint16_t dataLength, volatile unsigned int *flags,
                         volatile unsigned int *tx) {
     UNUSED(dataLength);
-    uint8_t privateKeyData[NEM_PRIVATE_KEY_LENGTH];
     uint32_t bip32Path[MAX_BIP32_PATH];
     uint32_t i;
     uint8_t bip32PathLength = *(dataBuffer++);
-    cx_ecfp_private_key_t privateKey;
-    cx_ecfp_public_key_t publicKey;
-    uint8_t algo;
     uint8_t p2Chain = p2 & 0x3F;
-    UNUSED(p2Chain);
+    uint8_t responseFormat = p2Chain & (P2_PUBLIC_KEY_ONLY | P2_RAW_ADDRESS);
+    // Addresses checked on the device are always derived, and never written to NVRAM
+    bool cacheEnabled = N_storage.settings.publicKeyCache && p1 == P1_NON_CONFIRM;
 
     if ((bip32PathLength < 1) || (bip32PathLength > MAX_BIP32_PATH)) {
         THROW(0x6a80);
@@ -78,6 +115,9 @@ void handle_public_key(uint8_t p1, uint8_t p2, uint8_t *dataBuffer,
     if ((p1 != P1_CONFIRM) && (p1 != P1_NON_CONFIRM)) {
         THROW(0x6B00);
     }
+    if (responseFormat == (P2_PUBLIC_KEY_ONLY | P2_RAW_ADDRESS)) {
+        THROW(0x6B00);
+    }
 
     //Read and convert path's data
     for (i = 0; i < bip32PathLength; i++) {
@@ -86,29 +126,26 @@ void handle_public_key(uint8_t p1, uint8_t p2, uint8_t *dataBuffer,
         dataBuffer += 4;
     }
     uint8_t network_type = *dataBuffer;
-    algo = get_algo(network_type);
-    io_seproxyhal_io_heartbeat();
-    BEGIN_TRY {
-        TRY {
-            os_perso_derive_node_bip32_seed_key(HDW_ED25519_SLIP10, CX_CURVE_Ed25519, bip32Path, bip32PathLength, privateKeyData, NULL, (unsigned char*) "ed25519-keccak seed", 19);
-            cx_ecfp_init_private_key(CX_CURVE_Ed25519, privateKeyData, NEM_PRIVATE_KEY_LENGTH, &privateKey);
-            io_seproxyhal_io_heartbeat();
-            cx_ecfp_generate_pair2(CX_CURVE_Ed25519, &publicKey, &privateKey, 1, algo);
-            explicit_bzero(&privateKey, sizeof(privateKey));
-            explicit_bzero(privateKeyData, sizeof(privateKeyData));
-            io_seproxyhal_io_heartbeat();
-            nem_public_key_and_address(&publicKey, network_type, algo, (uint8_t*) &nem_publickey, (char*) &nem_address, NEM_PRETTY_ADDRESS_LENGTH);
+    uint8_t algo = get_algo(network_type);
+    nem_response_format = responseFormat;
+
+    if (!cacheEnabled ||
+        !get_cached_public_key(bip32Path, bip32PathLength, network_type, nem_publickey, nem_rawaddress)) {
+        derive_public_key(bip32Path, bip32PathLength, algo);
+        // Skip the address hashing when only the public key is requested,
+        // cache entries are always complete
+        if (cacheEnabled || p1 == P1_CONFIRM || !(responseFormat & P2_PUBLIC_KEY_ONLY)) {
+            nem_raw_address(nem_publickey, network_type, algo, nem_rawaddress);
             io_seproxyhal_io_heartbeat();
         }
-        CATCH_OTHER(e) {
-            THROW(e);
-        }
-        FINALLY {
-            explicit_bzero(privateKeyData, sizeof(privateKeyData));
-            explicit_bzero(&privateKey, sizeof(privateKey));
+        if (cacheEnabled) {
+            cache_public_key(bip32Path, bip32PathLength, network_type, nem_publickey, nem_rawaddress);
         }
     }
-    END_TRY
+    // The base32 address is only needed for display and the default response
+    if (p1 == P1_CONFIRM || responseFormat == 0) {
+        base32_encode(nem_rawaddress, NEM_RAW_ADDRESS_LENGTH, nem_address, NEM_PRETTY_ADDRESS_LENGTH);
+    }
 
     if (p1 == P1_NON_CONFIRM) {
         *tx = set_result_get_publickey();
@@ -0,0 +1,31 @@
+/*******************************************************************************
+*   NEM Wallet
+*    (c) 2020 FDS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+#include "get_stack_usage.h"
+#include <os.h>
+#include "nem/nem_helpers.h"
+#include "stack_usage.h"
+
+#ifdef HAVE_STACK_PAINTING
+void handle_stack_usage(uint8_t p1, uint8_t p2, volatile unsigned int *tx) {
+    if (p1 != 0 || p2 != 0) {
+        THROW(0x6B00);
+    }
+    uint32_t length = write_uint32_be(G_io_apdu_buffer, 0, get_stack_size());
+    *tx = write_uint32_be(G_io_apdu_buffer, length, get_stack_high_water_mark());
+    THROW(0x9000);
+}
+#endif
@@ -0,0 +1,50 @@
+/*******************************************************************************
+*   NEM Wallet
+*    (c) 2020 FDS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+#include "get_trace.h"
+#include <os.h>
+#include "nem/nem_helpers.h"
+#include "trace.h"
+
+#ifdef HAVE_TRACE
+// Sequence number and count, then id and arguments of each event
+#define TRACE_HEADER_LENGTH 5
+#define TRACE_EVENT_LENGTH 9
+
+// Drains the oldest events, the host repeats the command until no event is returned
+void handle_trace(uint8_t p1, uint8_t p2, volatile unsigned int *tx) {
+    trace_event_t event;
+    uint32_t sequence;
+    uint32_t first = 0;
+    uint8_t count = 0;
+    uint32_t length = TRACE_HEADER_LENGTH;
+    if (p1 != 0 || p2 != 0) {
+        THROW(0x6B00);
+    }
+    while (length + TRACE_EVENT_LENGTH <= IO_APDU_BUFFER_SIZE - 2 && next_trace_event(&event, &sequence)) {
+        if (count++ == 0) {
+            first = sequence;
+        }
+        G_io_apdu_buffer[length++] = event.id;
+        length = write_uint32_be(G_io_apdu_buffer, length, event.arg0);
+        length = write_uint32_be(G_io_apdu_buffer, length, event.arg1);
+    }
+    write_uint32_be(G_io_apdu_buffer, 0, first);
+    G_io_apdu_buffer[4] = count;
+    *tx = length;
+    THROW(0x9000);
+}
+#endif
@@ -0,0 +1,127 @@
+/*******************************************************************************
+*   NEM Wallet
+*    (c) 2020 FDS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+#include "provide_mosaic_metadata.h"
+#include <os.h>
+#include <cx.h>
+#include "storage/storage.h"
+
+// Builds without a trusted key (MOSAIC_METADATA_KEY in the Makefile) do not support the command
+#ifdef MOSAIC_METADATA_KEY
+#define METADATA_VERSION 0x02
+#define METADATA_SIGNATURE_LENGTH 64
+#define MAX_DIVISIBILITY 6
+#define MAX_PERCENTILE_LEVY 10000
+
+// Uncompressed Ed25519 public key trusted to sign mosaic metadata
+static const uint8_t METADATA_KEY[] = {MOSAIC_METADATA_KEY};
+
+static uint8_t read_byte(const uint8_t *data, uint16_t length, uint16_t *offset) {
+    if (*offset >= length) {
+        THROW(0x6A80);
+    }
+    return data[(*offset)++];
+}
+
+// Printable ASCII string of 1 to maxLength characters, preceded by its length
+static uint8_t read_string(const uint8_t *data, uint16_t length, uint16_t *offset, char *dst, uint8_t maxLength) {
+    uint8_t stringLength = read_byte(data, length, offset);
+    if (stringLength == 0 || stringLength > maxLength || length - *offset < stringLength) {
+        THROW(0x6A80);
+    }
+    for (uint8_t i = 0; i < stringLength; i++) {
+        char c = (char) data[*offset + i];
+        if (c <= ' ' || c > '~') {
+            THROW(0x6A80);
+        }
+        dst[i] = c;
+    }
+    *offset += stringLength;
+    return stringLength;
+}
+
+static void read_mosaic_id(const uint8_t *data, uint16_t length, uint16_t *offset, mosaic_id_t *id) {
+    id->namespaceLength = read_string(data, length, offset, id->namespaceId, MAX_MOSAIC_NAMESPACE_LEN);
+    id->nameLength = read_string(data, length, offset, id->name, MAX_MOSAIC_NAME_LEN);
+}
+
+static uint64_t read_uint_be(const uint8_t *data, uint16_t length, uint16_t *offset, uint8_t size) {
+    uint64_t value = 0;
+    for (uint8_t i = 0; i < size; i++) {
+        value = (value << 8u) | read_byte(data, length, offset);
+    }
+    return value;
+}
+
+static uint8_t read_divisibility(const uint8_t *data, uint16_t length, uint16_t *offset) {
+    uint8_t divisibility = read_byte(data, length, offset);
+    if (divisibility > MAX_DIVISIBILITY) {
+        THROW(0x6A80);
+    }
+    return divisibility;
+}
+
+// Returns the length of the signed data, the signature follows
+static uint16_t read_metadata(const uint8_t *data, uint16_t length, mosaic_metadata_t *metadata) {
+    uint16_t offset = 0;
+    memset(metadata, 0, sizeof(mosaic_metadata_t));
+    if (read_byte(data, length, &offset) != METADATA_VERSION) {
+        THROW(0x6A80);
+    }
+    metadata->revision = read_uint_be(data, length, &offset, sizeof(uint32_t));
+    metadata->networkType = read_byte(data, length, &offset);
+    metadata->divisibility = read_divisibility(data, length, &offset);
+    read_mosaic_id(data, length, &offset, &metadata->id);
+    metadata->levyType = read_byte(data, length, &offset);
+    if (metadata->levyType != MOSAIC_LEVY_NONE) {
+        if (metadata->levyType != MOSAIC_LEVY_ABSOLUTE && metadata->levyType != MOSAIC_LEVY_PERCENTILE) {
+            THROW(0x6A80);
+        }
+        metadata->levyDivisibility = read_divisibility(data, length, &offset);
+        read_mosaic_id(data, length, &offset, &metadata->levyId);
+        metadata->levyFee = read_uint_be(data, length, &offset, sizeof(uint64_t));
+        if (metadata->levyType == MOSAIC_LEVY_PERCENTILE && metadata->levyFee > MAX_PERCENTILE_LEVY) {
+            THROW(0x6A80);
+        }
+    }
+    if (length - offset != METADATA_SIGNATURE_LENGTH) {
+        THROW(0x6A80);
+    }
+    return offset;
+}
+
+// No confirmation: the metadata only changes how amounts are displayed, and only
+// metadata signed by the trusted key is accepted. Revisions older than the cached
+// one are rejected, so the host cannot replay metadata that was since corrected.
+void handle_provide_mosaic_metadata(uint8_t p1, uint8_t p2, uint8_t *dataBuffer, uint16_t dataLength) {
+    mosaic_metadata_t metadata;
+    cx_ecfp_public_key_t key;
+
+    if (p1 != 0 || p2 != 0) {
+        THROW(0x6B00);
+    }
+    uint16_t signedLength = read_metadata(dataBuffer, dataLength, &metadata);
+    cx_ecfp_init_public_key(CX_CURVE_Ed25519, METADATA_KEY, sizeof(METADATA_KEY), &key);
+    if (!cx_eddsa_verify(&key, 0, CX_SHA512, dataBuffer, signedLength, NULL, 0,
+                         dataBuffer + signedLength, METADATA_SIGNATURE_LENGTH)) {
+        THROW(0x6A80);
+    }
+    if (!cache_mosaic(&metadata)) {
+        THROW(0x6A80);
+    }
+    THROW(0x9000);
+}
+#endif
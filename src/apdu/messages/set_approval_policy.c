@@ -0,0 +1,86 @@
+/*******************************************************************************
+*   NEM Wallet
+*    (c) 2020 FDS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+#include "set_approval_policy.h"
+#include <os.h>
+#include "ui/main/idle_menu.h"
+#include "ui/settings/settings_menu.h"
+#include "storage/storage.h"
+
+#define POLICY_FLAG_CONTACTS_ONLY 0x01u
+// Flags, amount cap, fee cap, period cap and period length in hours
+#define POLICY_DATA_LENGTH (1 + 3 * sizeof(uint64_t) + sizeof(uint16_t))
+
+// Policy waiting for the confirmation of the user
+static policy_t pendingPolicy;
+
+static void send_status(uint16_t sw) {
+    G_io_apdu_buffer[0] = sw >> 8u;
+    G_io_apdu_buffer[1] = sw & 0xFFu;
+    // Send back the response, do not restart the event loop
+    io_exchange(CHANNEL_APDU | IO_RETURN_AFTER_TX, 2);
+    // Display back the original UX
+    display_idle_menu();
+}
+
+static void on_policy_approved() {
+    policy_state_t state;
+    // Spending approved with the previous policy does not count
+    memset(&state, 0, sizeof(policy_state_t));
+    write_policy_state(&state);
+    write_policy(&pendingPolicy);
+    send_status(0x9000);
+}
+
+static void on_policy_rejected() {
+    send_status(0x6985);
+}
+
+static uint64_t read_amount(const uint8_t *data) {
+    uint64_t value = 0;
+    for (uint8_t i = 0; i < sizeof(uint64_t); i++) {
+        value = (value << 8u) | data[i];
+    }
+    if (value > MAX_POLICY_AMOUNT) {
+        THROW(0x6A80);
+    }
+    return value;
+}
+
+void handle_set_approval_policy(uint8_t p1, uint8_t p2, uint8_t *dataBuffer,
+                                uint16_t dataLength, volatile unsigned int *flags) {
+    if (p1 != 0 || p2 != 0) {
+        THROW(0x6B00);
+    }
+    if (dataLength != POLICY_DATA_LENGTH || (dataBuffer[0] & ~POLICY_FLAG_CONTACTS_ONLY) != 0) {
+        THROW(0x6A80);
+    }
+    uint16_t hours = (dataBuffer[25] << 8u) | dataBuffer[26];
+    if (hours == 0 || hours > MAX_POLICY_PERIOD_HOURS) {
+        THROW(0x6A80);
+    }
+
+    memset(&pendingPolicy, 0, sizeof(policy_t));
+    // Enabled once approved, the user can then disable it from the Settings menu
+    pendingPolicy.enabled = 1;
+    pendingPolicy.contactsOnly = (dataBuffer[0] & POLICY_FLAG_CONTACTS_ONLY) != 0;
+    pendingPolicy.maxAmount = read_amount(dataBuffer + 1);
+    pendingPolicy.maxFee = read_amount(dataBuffer + 9);
+    pendingPolicy.periodCap = read_amount(dataBuffer + 17);
+    pendingPolicy.periodLength = hours * 3600u;
+    display_policy_confirmation_ui(&pendingPolicy, on_policy_approved, on_policy_rejected);
+    *flags |= IO_ASYNCH_REPLY;
+}
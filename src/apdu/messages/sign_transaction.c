@@ -21,17 +21,52 @@
 #include "nem/nem_helpers.h"
 #include "ui/main/idle_menu.h"
 #include "transaction/transaction.h"
+#include "ui/transaction/review_menu.h"
+#include "nem/format/format.h"
+#include "nem/format/readers.h"
+#include "nem/policy.h"
+#include "storage/storage.h"
+#include "perf.h"
 
 #define PREFIX_LENGTH   4
+// Offset (2 bytes, big endian) and length (1 byte) of the message bytes to send
+#define WINDOW_REQUEST_LENGTH 3
+#define PULL_FIRST_BYTE 0xFFu
+#define NO_WINDOW 0xFFu
 
 parse_context_t parseContext;
+pull_context_t pullContext;
 
 void handle_packet_content(uint8_t p1, uint8_t p2, uint8_t *workBuffer,
-                         uint8_t dataLength, volatile unsigned int *flags);
+                         uint8_t dataLength, volatile unsigned int *flags, volatile unsigned int *tx);
 
-void sign_transaction() {
+// Derive the signing key of the transaction path into the transaction context
+static void derive_signing_key() {
     uint8_t privateKeyData[64];
+
+    BEGIN_TRY {
+        TRY {
+            io_seproxyhal_io_heartbeat();
+            PERF_START(PERF_DERIVE);
+            os_perso_derive_node_bip32_seed_key(HDW_ED25519_SLIP10, CX_CURVE_Ed25519, transactionContext.bip32Path, transactionContext.pathLength, privateKeyData, NULL, (unsigned char*) "ed25519-keccak seed", 19);
+            PERF_STOP(PERF_DERIVE);
+            memcpy(transactionContext.privateKey, privateKeyData, NEM_PRIVATE_KEY_LENGTH);
+            transactionContext.keyDerived = 1;
+            io_seproxyhal_io_heartbeat();
+        }
+        CATCH_OTHER(e) {
+            THROW(e);
+        }
+        FINALLY {
+            explicit_bzero(privateKeyData, sizeof(privateKeyData));
+        }
+    }
+    END_TRY
+}
+
+void sign_transaction() {
     cx_ecfp_private_key_t privateKey;
+    cx_ecfp_public_key_t publicKey;
     uint32_t tx = 0;
 
     if (signState != PENDING_REVIEW) {
@@ -40,6 +75,12 @@ void sign_transaction() {
         return;
     }
 
+    if (pullContext.waiting) {
+        // The pending command is answered by a window request, reply to the window instead
+        pullContext.pendingAction = sign_transaction;
+        return;
+    }
+
     // Abort if we accidentally end up here again after the transaction has already been signed
     if (parseContext.data == NULL) {
         display_idle_menu();
@@ -48,21 +89,35 @@ void sign_transaction() {
 
     BEGIN_TRY {
         TRY {
+            if (!transactionContext.keyDerived) {
+                derive_signing_key();
+            }
+            cx_ecfp_init_private_key(CX_CURVE_Ed25519, transactionContext.privateKey, NEM_PRIVATE_KEY_LENGTH, &privateKey);
             io_seproxyhal_io_heartbeat();
-            os_perso_derive_node_bip32_seed_key(HDW_ED25519_SLIP10, CX_CURVE_Ed25519, transactionContext.bip32Path, transactionContext.pathLength, privateKeyData, NULL, (unsigned char*) "ed25519-keccak seed", 19);
-            cx_ecfp_init_private_key(CX_CURVE_Ed25519, privateKeyData, NEM_PRIVATE_KEY_LENGTH, &privateKey);
-            explicit_bzero(privateKeyData, sizeof(privateKeyData));
-            io_seproxyhal_io_heartbeat();
+            PERF_START(PERF_SIGN);
             tx = (uint32_t) cx_eddsa_sign(&privateKey, CX_LAST, transactionContext.algo, transactionContext.rawTx,
                                               transactionContext.rawTxLength, NULL, 0, G_io_apdu_buffer,
                                               IO_APDU_BUFFER_SIZE, NULL);
-
+            PERF_STOP(PERF_SIGN);
+            if (transactionContext.extendedSignature) {
+                // Saves the host a GET_PUBLIC_KEY round trip and the hashing to announce the transaction
+                io_seproxyhal_io_heartbeat();
+                cx_ecfp_generate_pair2(CX_CURVE_Ed25519, &publicKey, &privateKey, 1, transactionContext.algo);
+                nem_public_key(&publicKey, G_io_apdu_buffer + tx);
+                tx += NEM_PUBLIC_KEY_LENGTH;
+                sha_calculation(transactionContext.algo, transactionContext.rawTx, transactionContext.rawTxLength,
+                                G_io_apdu_buffer + tx, NEM_TRANSACTION_HASH_LENGTH);
+                tx += NEM_TRANSACTION_HASH_LENGTH;
+            }
+            // Only transactions within policy count in the spending of the period
+            if (parseContext.result.withinPolicy) {
+                record_policy_approval(&parseContext);
+            }
         }
         CATCH_OTHER(e) {
             THROW(e);
         }
         FINALLY {
-            explicit_bzero(privateKeyData, sizeof(privateKeyData));
             explicit_bzero(&privateKey, sizeof(privateKey));
 
             // Always reset transaction context after a transaction has been signed
@@ -87,6 +142,11 @@ void reject_transaction() {
         return;
     }
 
+    if (pullContext.waiting) {
+        pullContext.pendingAction = reject_transaction;
+        return;
+    }
+
     G_io_apdu_buffer[0] = 0x69;
     G_io_apdu_buffer[1] = 0x85;
 
@@ -109,7 +169,7 @@ bool hasMore(uint8_t p1) {
 }
 
 void handle_first_packet(uint8_t p1, uint8_t p2, uint8_t *workBuffer,
-                       uint8_t dataLength, volatile unsigned int *flags) {
+                       uint8_t dataLength, volatile unsigned int *flags, volatile unsigned int *tx) {
     uint32_t i;
     if (!isFirst(p1)) {
         THROW(0x6A80);
@@ -133,27 +193,216 @@ void handle_first_packet(uint8_t p1, uint8_t p2, uint8_t *workBuffer,
         workBuffer += 4;
         dataLength -= 4;
     }
+    transactionContext.extendedSignature = (p2 & P2_EXTENDED_SIGNATURE) != 0;
+    parseContext.pullMessage = (p2 & P2_PULL_MESSAGE) != 0;
     transactionContext.network_type = get_network_type(transactionContext.bip32Path);
     if (transactionContext.network_type == MAINNET || transactionContext.network_type == TESTNET) {
         transactionContext.algo = CX_KECCAK;
     } else {
         transactionContext.algo = CX_SHA3;
     }
-    handle_packet_content(p1, p2, workBuffer, dataLength, flags);
+    parseContext.networkType = transactionContext.network_type;
+    handle_packet_content(p1, p2, workBuffer, dataLength, flags, tx);
 }
 
 void handle_subsequent_packet(uint8_t p1, uint8_t p2, uint8_t *workBuffer,
-                            uint8_t dataLength, volatile unsigned int *flags) {
+                            uint8_t dataLength, volatile unsigned int *flags, volatile unsigned int *tx) {
     if (isFirst(p1)) {
         THROW(0x6A80);
     }
 
-    handle_packet_content(p1, p2, workBuffer, dataLength, flags);
+    handle_packet_content(p1, p2, workBuffer, dataLength, flags, tx);
 }
 
-void handle_packet_content(uint8_t p1, uint8_t p2, uint8_t *workBuffer,
-                         uint8_t dataLength, volatile unsigned int *flags) {
+static field_t *pulled_field() {
+    return &parseContext.result.fields[parseContext.pulledField];
+}
+
+static void window_range(uint8_t window, uint32_t *offset, uint32_t *length) {
+    if (window == PULL_FIRST_BYTE) {
+        *offset = 0;
+        *length = 1;
+    } else {
+        format_window_range(pulled_field(), window, offset, length);
+    }
+}
+
+// Write a window request to the APDU buffer, returns its length
+static uint32_t set_window_request(uint8_t window) {
+    uint32_t offset, length;
+    window_range(window, &offset, &length);
+    pullContext.requestedWindow = window;
+    pullContext.waiting = true;
+    G_io_apdu_buffer[0] = offset >> 8u;
+    G_io_apdu_buffer[1] = offset;
+    G_io_apdu_buffer[2] = length;
+    return WINDOW_REQUEST_LENGTH;
+}
+
+static void window_tag(uint8_t window, const uint8_t *data, uint32_t length, uint8_t *tag) {
+    cx_sha3_t hash;
+    cx_keccak_init(&hash, 256);
+    cx_hash(&hash.header, 0, pullContext.nonce, PULL_NONCE_LENGTH, NULL, 0);
+    cx_hash(&hash.header, 0, &window, sizeof(window), NULL, 0);
+    cx_hash(&hash.header, CX_LAST, data, length, tag, PULL_TAG_LENGTH);
+}
+
+// Hash of the transaction of the multisig signature, as signed
+static const field_t *signed_hash_field() {
+    for (uint8_t i = 0; i < parseContext.result.numFields; i++) {
+        if (parseContext.result.fields[i].id == NEM_HASH256) {
+            return &parseContext.result.fields[i];
+        }
+    }
+    return NULL;
+}
+
+// Windows of the pulled message are shown once received from the host
+static bool format_pulled_window(const field_t *field, uint8_t window, char *dst) {
+    uint32_t offset, length;
+    if (parseContext.pulledField == 0 || field != pulled_field()) {
+        return false;
+    }
+    format_window_range(field, window, &offset, &length);
+    if (length == 0 || window == pullContext.cachedWindow) {
+        format_message_window(field, pullContext.data.window, length, dst);
+    } else {
+        strcpy(dst, "Loading...");
+        if (!pullContext.waiting) {
+            // Requested by send_window_request() once the event is processed, not while the screen is laid out
+            pullContext.requestedWindow = window;
+            pullContext.requestPending = true;
+        }
+    }
+    return true;
+}
+
+void send_window_request() {
+    if (!pullContext.requestPending || pullContext.waiting || signState != PENDING_REVIEW) {
+        return;
+    }
+    pullContext.requestPending = false;
+    // Answer the pending command with a request for the window
+    uint32_t tx = set_window_request(pullContext.requestedWindow);
+    G_io_apdu_buffer[tx++] = 0x90;
+    G_io_apdu_buffer[tx++] = 0x00;
+    io_exchange(CHANNEL_APDU | IO_RETURN_AFTER_TX, tx);
+}
+
+// The key is kept until the review ends, reset_transaction_context() wipes it on every exit
+static void pre_derive_signing_key() {
+    if (!transactionContext.keyDerived && signState == PENDING_REVIEW) {
+        derive_signing_key();
+    }
+}
+
+static void show_review() {
+    // Move the key derivation out of the way between approval and signature: the key
+    // is derived once the user reaches the approval step, not for the whole review
+    set_approval_step_action(N_storage.settings.preDeriveKey ? pre_derive_signing_key : NULL);
+    set_window_formatter(parseContext.pulledField != 0 ? format_pulled_window : NULL);
+    review_transaction(&parseContext.result, sign_transaction, reject_transaction);
+}
+
+// The transaction of the multisig signature is sent without its message payload, which
+// is requested from the host right away to check the signed hash of the transaction
+static void start_pulling_message(volatile unsigned int *tx) {
+    uint32_t innerStart = parseContext.signDataLength + sizeof(uint32_t);
+    uint32_t payloadLength = pulled_field()->length;
+    if (payloadLength > MAX_MESSAGE_LEN ||
+        read_uint32(parseContext.data + parseContext.signDataLength) + innerStart != parseContext.length + payloadLength) {
+        THROW(0x6a80);
+    }
+    cx_rng(pullContext.nonce, PULL_NONCE_LENGTH);
+    if (transactionContext.algo == CX_KECCAK) {
+        cx_keccak_init(&pullContext.data.hash, 256);
+    } else {
+        cx_sha3_init(&pullContext.data.hash, 256);
+    }
+    cx_hash(&pullContext.data.hash.header, 0, parseContext.data + innerStart, parseContext.pulledOffset - innerStart,
+            NULL, 0);
+    signState = PULLING_MESSAGE;
+    *tx = set_window_request(PULL_FIRST_BYTE);
+    THROW(0x9000);
+}
+
+// First pass: hash the message and tag its windows
+static void receive_pulled_message(const uint8_t *data, uint32_t offset, uint32_t length, volatile unsigned int *flags,
+                                   volatile unsigned int *tx) {
+    uint8_t window = pullContext.requestedWindow;
+    uint8_t nextWindow = 0;
+    if (window == PULL_FIRST_BYTE) {
+        pullContext.firstByte = data[0];
+        pulled_field()->data = &pullContext.firstByte;
+        // Nothing to display after the marker of an empty hex message
+        format_window_range(pulled_field(), 0, &offset, &length);
+        pullContext.numWindows = length == 0 ? 0 : format_window_count(pulled_field());
+        offset = 0;
+        length = 1;
+    } else {
+        window_tag(window, data, length, pullContext.tags[window]);
+        nextWindow = window + 1;
+    }
+    // Windows of plain messages start with the first byte, which is already hashed
+    uint32_t skip = pullContext.hashedLength - offset;
+    cx_hash(&pullContext.data.hash.header, 0, data + skip, length - skip, NULL, 0);
+    pullContext.hashedLength = offset + length;
+
+    if (nextWindow < pullContext.numWindows) {
+        *tx = set_window_request(nextWindow);
+        THROW(0x9000);
+    }
+
+    uint8_t hash[NEM_TRANSACTION_HASH_LENGTH];
+    const field_t *signedHash = signed_hash_field();
+    cx_hash(&pullContext.data.hash.header, CX_LAST, parseContext.data + parseContext.pulledOffset,
+            parseContext.length - parseContext.pulledOffset, hash, sizeof(hash));
+    if (pullContext.hashedLength != pulled_field()->length || signedHash == NULL ||
+        signedHash->length != NEM_TRANSACTION_HASH_LENGTH || memcmp(hash, signedHash->data, sizeof(hash)) != 0) {
+        THROW(0x6a80);
+    }
+    pullContext.cachedWindow = NO_WINDOW;
+    signState = PENDING_REVIEW;
+    show_review();
+    *flags |= IO_ASYNCH_REPLY;
+}
+
+// Message bytes sent by the host in reply to a window request
+static void handle_window(uint8_t *workBuffer, uint8_t dataLength, volatile unsigned int *flags,
+                          volatile unsigned int *tx) {
+    uint32_t offset, length;
+    if (!pullContext.waiting) {
+        THROW(0x6A80);
+    }
+    window_range(pullContext.requestedWindow, &offset, &length);
+    if (dataLength != length) {
+        THROW(0x6700);
+    }
+    pullContext.waiting = false;
+
+    if (signState == PULLING_MESSAGE) {
+        receive_pulled_message(workBuffer, offset, length, flags, tx);
+        return;
+    }
 
+    uint8_t tag[PULL_TAG_LENGTH];
+    window_tag(pullContext.requestedWindow, workBuffer, length, tag);
+    if (memcmp(tag, pullContext.tags[pullContext.requestedWindow], PULL_TAG_LENGTH) != 0) {
+        THROW(0x6a80);
+    }
+    memcpy(pullContext.data.window, workBuffer, length);
+    pullContext.cachedWindow = pullContext.requestedWindow;
+    *flags |= IO_ASYNCH_REPLY;
+    if (pullContext.pendingAction != NULL) {
+        pullContext.pendingAction();
+    } else {
+        refresh_review_menu();
+    }
+}
+
+void handle_packet_content(uint8_t p1, uint8_t p2, uint8_t *workBuffer,
+                         uint8_t dataLength, volatile unsigned int *flags, volatile unsigned int *tx) {
+    PERF_START(PERF_PACKET);
     uint16_t totalLength = PREFIX_LENGTH + parseContext.length + dataLength;
     if (totalLength > MAX_RAW_TX) {
         // Abort if the user is trying to sign a too large transaction
@@ -167,34 +416,46 @@ void handle_packet_content(uint8_t p1, uint8_t p2, uint8_t *workBuffer,
     if (hasMore(p1)) {
         // Reply to sender with status OK
         signState = WAITING_FOR_MORE;
+        PERF_STOP(PERF_PACKET);
         THROW(0x9000);
     } else {
         // No more data to receive, finish up and present transaction to user
         signState = PENDING_REVIEW;
 
-        transactionContext.rawTxLength = parseContext.length;
-
         // Try to parse the transaction. If the parsing fails, throw an exception
         // to cause the processing to abort and the transaction context to be reset.
         if (parse_txn_context(&parseContext)) {
             // Mask real cause behind generic error (INCORRECT_DATA)
             THROW(0x6a80);
         }
+        transactionContext.rawTxLength = parseContext.signDataLength;
 
-        review_transaction(&parseContext.result, sign_transaction, reject_transaction);
+        if (parseContext.pulledField != 0) {
+            PERF_STOP(PERF_PACKET);
+            start_pulling_message(tx);
+        }
+        show_review();
 
         *flags |= IO_ASYNCH_REPLY;
+        PERF_STOP(PERF_PACKET);
     }
 }
 
 void handle_sign(uint8_t p1, uint8_t p2, uint8_t *workBuffer,
-                uint8_t dataLength, volatile unsigned int *flags) {
+                uint8_t dataLength, volatile unsigned int *flags, volatile unsigned int *tx) {
+    if ((p1 & P1_MASK_WINDOW) != 0) {
+        if (signState != PULLING_MESSAGE && signState != PENDING_REVIEW) {
+            THROW(0x6A80);
+        }
+        handle_window(workBuffer, dataLength, flags, tx);
+        return;
+    }
     switch (signState) {
         case IDLE:
-            handle_first_packet(p1, p2, workBuffer, dataLength, flags);
+            handle_first_packet(p1, p2, workBuffer, dataLength, flags, tx);
             break;
         case WAITING_FOR_MORE:
-            handle_subsequent_packet(p1, p2, workBuffer, dataLength, flags);
+            handle_subsequent_packet(p1, p2, workBuffer, dataLength, flags, tx);
             break;
         default:
             THROW(0x6A80);
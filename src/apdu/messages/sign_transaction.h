@@ -19,11 +19,54 @@
 #define LEDGER_APP_NEM_SIGNTRANSACTION_H
 
 #include <stdint.h>
+#include "common.h"
 #include "nem/parse/nem_parse.h"
 
+#define PULL_NONCE_LENGTH 16
+// Tags are shorter on the Nano S to save its RAM: a forged window still passes with
+// probability 2^-32 only, and a rejected one ends the signature and its nonce
+#ifdef TARGET_NANOS
+#define PULL_TAG_LENGTH 4
+#else
+#define PULL_TAG_LENGTH 8
+#endif
+
+// Message of a multisig signature pulled from the host window by window (P2_PULL_MESSAGE).
+// The whole message is received once and checked against the signed hash of the
+// transaction, then the windows requested again during the review are checked against
+// the tags of the first pass.
+typedef struct pull_context_t {
+    union {
+        // Hash of the transaction of the multisig signature during the first pass
+        cx_sha3_t hash;
+        // Bytes of cachedWindow during the review
+        uint8_t window[MESSAGE_WINDOW_LEN];
+    } data;
+    // Key of the window tags
+    uint8_t nonce[PULL_NONCE_LENGTH];
+    uint8_t tags[MAX_MESSAGE_WINDOWS][PULL_TAG_LENGTH];
+    // First byte of the payload, tells hex messages apart
+    uint8_t firstByte;
+    uint8_t numWindows;
+    // Number of bytes of the payload hashed during the first pass
+    uint32_t hashedLength;
+    // Window requested from the host, the command that answers it is the pending one
+    uint8_t requestedWindow;
+    // Set by the review when it needs a window, the request is sent by send_window_request()
+    bool requestPending;
+    bool waiting;
+    uint8_t cachedWindow;
+    // Approval or rejection made while waiting for a window, run once it is received
+    action_t pendingAction;
+} pull_context_t;
+
 extern parse_context_t parseContext;
+extern pull_context_t pullContext;
 
 void handle_sign(uint8_t p1, uint8_t p2, uint8_t *workBuffer,
-                uint8_t dataLength, volatile unsigned int *flags);
+                uint8_t dataLength, volatile unsigned int *flags, volatile unsigned int *tx);
+// Answers the pending command with the window requested by the review, if any.
+// Called by the event loop after the UX has processed an event.
+void send_window_request();
 
 #endif //LEDGER_APP_NEM_SIGNTRANSACTION_H
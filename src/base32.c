@@ -71,3 +71,30 @@ int base32_encode(const uint8_t *data, int length, char *result, int bufSize) {
         return -1;
     }
 }
+
+int base32_decode(const char *encoded, int length, uint8_t *result, int bufSize) {
+    int buffer = 0;
+    int bitsLeft = 0;
+    int count = 0;
+    for (int i = 0; i < length && encoded[i] != '='; i++) {
+        char c = encoded[i];
+        int value;
+        if (c >= 'A' && c <= 'Z') {
+            value = c - 'A';
+        } else if (c >= '2' && c <= '7') {
+            value = c - '2' + 26;
+        } else {
+            return -1;
+        }
+        buffer = ((buffer << 5) | value) & 0xFFF;
+        bitsLeft += 5;
+        if (bitsLeft >= 8) {
+            if (count >= bufSize) {
+                return -1;
+            }
+            bitsLeft -= 8;
+            result[count++] = (buffer >> bitsLeft) & 0xFF;
+        }
+    }
+    return count;
+}
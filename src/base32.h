@@ -21,5 +21,7 @@
 #include <stdint.h>
 
 int base32_encode(const uint8_t *data, int length, char *result, int bufSize);
+// Returns the number of decoded bytes, or -1 for an invalid character or a too small buffer
+int base32_decode(const char *encoded, int length, uint8_t *result, int bufSize);
 
 #endif //_BASE32_H_
@@ -24,16 +24,45 @@
 // Hardware independent limits
 #define MAX_BIP32_PATH 5
 #define MAX_FIELDNAME_LEN 50
+// Longest message payload accepted by the network
+#define MAX_MESSAGE_LEN 1024
+// Labels of the address book entries
+#define MAX_CONTACT_LABEL_LEN 16
 
 // Hardware dependent limits
 //   Ledger Nano X has 30K RAM
+//   Ledger Nano S Plus has 44K RAM
 //   Ledger Nano S has 4K RAM
+// Messages longer than MESSAGE_WINDOW_LEN characters are reviewed in at most
+// MAX_MESSAGE_WINDOWS windows, a window of the longest hex message (MAX_RAW_TX or
+// MAX_MESSAGE_LEN bytes when pulled from the host) must fit in MAX_FIELD_LEN and a
+// pulled window in an APDU.
+// GLOBALS_RAM_BUDGET bounds the largest globals of the application (checked in
+// global.c), the rest of the RAM is left to the stack, the SDK and the small globals
+// PULL_CONTEXT_RAM_BUDGET bounds the state of pulled messages, which every transaction
+// pays for on the Nano S (checked by tests/ram_budget.c)
 #if defined(TARGET_NANOX)
 
 #define MAX_FIELD_COUNT 60
 #define MAX_FIELD_LEN 1024
 #define MAX_RAW_TX 10000
 #define DISPLAY_SEGMENTED_ADDR false
+#define MESSAGE_WINDOW_LEN 240
+#define MAX_MESSAGE_WINDOWS 32
+#define ADDRESS_BOOK_SIZE 256
+#define GLOBALS_RAM_BUDGET 20480
+
+#elif defined(TARGET_NANOS2)
+
+// Same screen as the Nano X, the extra RAM goes to longer transactions
+#define MAX_FIELD_COUNT 96
+#define MAX_FIELD_LEN 1024
+#define MAX_RAW_TX 16384
+#define DISPLAY_SEGMENTED_ADDR false
+#define MESSAGE_WINDOW_LEN 240
+#define MAX_MESSAGE_WINDOWS 32
+#define ADDRESS_BOOK_SIZE 256
+#define GLOBALS_RAM_BUDGET 32768
 
 #elif defined(TARGET_NANOS)
 
@@ -41,6 +70,11 @@
 #define MAX_FIELD_LEN 128
 #define MAX_RAW_TX 800
 #define DISPLAY_SEGMENTED_ADDR true
+#define MESSAGE_WINDOW_LEN 96
+#define MAX_MESSAGE_WINDOWS 24
+#define ADDRESS_BOOK_SIZE 64
+#define GLOBALS_RAM_BUDGET 2816
+#define PULL_CONTEXT_RAM_BUDGET 560
 
 #endif
 
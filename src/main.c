@@ -21,8 +21,12 @@
 #include <ux.h>
 #include "apdu/entry.h"
 #include "apdu/global.h"
+#include "apdu/messages/sign_transaction.h"
 #include "ui/main/idle_menu.h"
 #include "ui/address/address_ui.h"
+#include "storage/storage.h"
+#include "perf.h"
+#include "stack_usage.h"
 
 // IO_SEPROXYHAL_BUFFER_SIZE_B define in Makefile
 unsigned char G_io_seproxyhal_spi_buffer[IO_SEPROXYHAL_BUFFER_SIZE_B];
@@ -151,6 +155,9 @@ unsigned char io_event(unsigned char channel) {
         break;
 
     case SEPROXYHAL_TAG_TICKER_EVENT:
+#ifdef PERF_TICKER_PERIOD
+        perfTicks += PERF_TICKER_PERIOD;
+#endif
         UX_TICKER_EVENT(G_io_seproxyhal_spi_buffer, {
             if (UX_ALLOWED) {
                 // redisplay screen
@@ -164,6 +171,9 @@ unsigned char io_event(unsigned char channel) {
         break;
     }
 
+    // Windows of a pulled message needed by the screen just laid out
+    send_window_request();
+
     // close the event if not done previously (by a display or whatever)
     if (!io_seproxyhal_spi_is_status_sent()) {
         io_seproxyhal_general_status();
@@ -191,6 +201,10 @@ __attribute__((section(".boot"))) int main(void) {
     // ensure exception will work as planned
     os_boot();
 
+#ifdef HAVE_STACK_PAINTING
+    paint_stack();
+#endif
+
     for (;;) {
         reset_transaction_context();
 
@@ -199,6 +213,8 @@ __attribute__((section(".boot"))) int main(void) {
             TRY {
                 io_seproxyhal_init();
 
+                init_storage();
+
 #ifdef TARGET_NANOX
                 // grab the current plane mode setting
                 G_io_app.plane_mode = os_setting_get(OS_SETTING_PLANEMODE, NULL, 0);
@@ -0,0 +1,39 @@
+/*******************************************************************************
+*   NEM Wallet
+*    (c) 2020 FDS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+#include "contacts.h"
+#include <stddef.h>
+#include "nem_helpers.h"
+#ifndef FUZZ
+#include "storage/storage.h"
+#endif
+
+uint32_t contact_hash(const uint8_t *address) {
+    return fnv1a(FNV1A_BASIS, address, NEM_ADDRESS_LENGTH);
+}
+
+const char *find_contact(const uint8_t *address, uint32_t length) {
+#ifndef FUZZ
+    if (length != NEM_ADDRESS_LENGTH) {
+        return NULL;
+    }
+    return get_contact_label(address);
+#else
+    (void) address;
+    (void) length;
+    return NULL;
+#endif
+}
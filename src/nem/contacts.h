@@ -0,0 +1,29 @@
+/*******************************************************************************
+*   NEM Wallet
+*    (c) 2020 FDS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+#ifndef LEDGER_APP_NEM_CONTACTS_H
+#define LEDGER_APP_NEM_CONTACTS_H
+
+#include <stdint.h>
+
+// Hash of an address of NEM_ADDRESS_LENGTH base32 characters, indexes the address book
+uint32_t contact_hash(const uint8_t *address);
+
+// Label of the address in the address book, NULL if it is not in it.
+// Always NULL in host parser builds, which have no NVRAM.
+const char *find_contact(const uint8_t *address, uint32_t length);
+
+#endif //LEDGER_APP_NEM_CONTACTS_H
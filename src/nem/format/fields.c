@@ -20,97 +20,33 @@
 #include "limitations.h"
 #include "readers.h"
 #include "printers.h"
+#include "nem_helpers.h"
 
-void resolve_fieldname(const field_t *field, char* dst) {
-    if (field->dataType == STI_UINT32) {
-        switch (field->id) {
-            CASE_FIELDNAME(NEM_UINT32_TRANSACTION_TYPE, "Transaction Type")
-            CASE_FIELDNAME(NEM_UINT32_INNER_TRANSACTION_TYPE, "Inner TX Type")
-            CASE_FIELDNAME(NEM_UINT32_DETAIL_TRANSACTION_TYPE, "Detail TX Type")
-            CASE_FIELDNAME(NEM_UINT32_MOSAIC_COUNT, "Mosaics")
-            CASE_FIELDNAME(NEM_UINT32_IT_MODE, "Importance Mode")
-            CASE_FIELDNAME(NEM_UINT32_AM_COSIGNATORY_NUM, "Cosignatory Num")
-            CASE_FIELDNAME(NEM_UINT32_AM_MODICATION_TYPE, "Mod. Type")
-            CASE_FIELDNAME(NEM_UINT32_AM_RELATIVE_CHANGE, "Relative Change")
-            CASE_FIELDNAME(NEM_UINT32_LEVY_FEE_TYPE, "Levy Fee Type")
-        }
-    }
-
-    if (field->dataType == STI_UINT64) {
-        switch (field->id) {
-            CASE_FIELDNAME(NEM_UINT64_DURATION, "Duration")
-        }
-    }
-
-    if (field->dataType == STI_HASH256) {
-        switch (field->id) {
-            CASE_FIELDNAME(NEM_HASH256, "SHA3 Tx Hash")
-            CASE_FIELDNAME(NEM_PUBLICKEY_IT_REMOTE, "Rmt. Public Key")
-            CASE_FIELDNAME(NEM_PUBLICKEY_AM_COSIGNATORY, "Cosignatory PbK")
-        }
-    }
-
-    if (field->dataType == STI_ADDRESS) {
-        switch (field->id) {
-            CASE_FIELDNAME(NEM_STR_RECIPIENT_ADDRESS, "Recipient")
-            CASE_FIELDNAME(NEM_STR_MULTISIG_ADDRESS, "Multisig Address")
-            CASE_FIELDNAME(NEM_STR_SINK_ADDRESS, "Sink Address")
-            CASE_FIELDNAME(NEM_STR_LEVY_ADDRESS, "Levy Address")
-            CASE_FIELDNAME(NEM_PUBLICKEY_IT_REMOTE, "Rmt. Address")
-            CASE_FIELDNAME(NEM_PUBLICKEY_AM_COSIGNATORY, "CosignatoryAddr")
-        }
-    }
+#define FIELD_INDEX(id, dataType, label, formatter, values) [id] = FIELD_POSITION_##id + 1,
+#define FIELD_TYPE(id, dataType, label, formatter, values) dataType,
+#define FIELD_LABEL(id, dataType, label, formatter, values) label,
 
-    if (field->dataType == STI_PROPERTY) {
-        switch (field->id) {
-            case NEM_STR_PROPERTY:
-            {
-                // field->data = len name, name, len value, value (ignore field->length)
-                snprintf_ascii(dst, 0, MAX_FIELDNAME_LEN, field->data + sizeof(uint32_t), read_uint32(field->data));
-                return ;
-            }
-        }
-    }
-
-    if (field->dataType == STI_MOSAIC_CURRENCY) {
-        switch (field->id) {
-            CASE_FIELDNAME(NEM_MOSAIC_AMOUNT, "Amount")
-            CASE_FIELDNAME(NEM_MOSAIC_UNITS, "Micro Units")
-            CASE_FIELDNAME(NEM_MOSAIC_DELETE_SUPPLY_DELTA, "Delete Supply")
-            CASE_FIELDNAME(NEM_MOSAIC_CREATE_SUPPLY_DELTA, "Create Supply")
-        }
-    }
-
-    if (field->dataType == STI_NEM) {
-        switch (field->id) {
-            CASE_FIELDNAME(NEM_UINT64_TXN_FEE, "Fee")
-            CASE_FIELDNAME(NEM_UINT64_RENTAL_FEE, "Rental Fee")
-            CASE_FIELDNAME(NEM_MOSAIC_AMOUNT, "Amount")
-            CASE_FIELDNAME(NEM_UINT64_LEVY_FEE, "Levy Fee")
-            CASE_FIELDNAME(NEM_UINT64_MULTISIG_FEE, "Multisig Fee")
-        }
-    }
+// Position of every field id plus one, 0 for unknown ids
+static const uint8_t FIELD_INDEXES[256] = {NEM_FIELD_SCHEMA(FIELD_INDEX)};
+static const uint8_t FIELD_TYPES[NEM_FIELD_COUNT] = {NEM_FIELD_SCHEMA(FIELD_TYPE)};
+static const char *const FIELD_LABELS[NEM_FIELD_COUNT] = {NEM_FIELD_SCHEMA(FIELD_LABEL)};
 
-    if (field->dataType == STI_MESSAGE) {
-        switch (field->id) {
-            CASE_FIELDNAME(NEM_STR_TXN_MESSAGE, "Message")
-            CASE_FIELDNAME(NEM_STR_ENC_MESSAGE, "Message")
-        }
+uint8_t field_position(const field_t *field) {
+    uint8_t index = FIELD_INDEXES[field->id];
+    if (index == 0 || FIELD_TYPES[index - 1] != field->dataType) {
+        return NEM_FIELD_COUNT;
     }
+    return index - 1;
+}
 
-    if (field->dataType == STI_STR) {
-        switch (field->id) {
-            CASE_FIELDNAME(NEM_MOSAIC_UNKNOWN_TYPE, "Unknown Mosaic")
-            CASE_FIELDNAME(NEM_STR_TRANSFER_MOSAIC, "Namespace")
-            CASE_FIELDNAME(NEM_STR_NAMESPACE, "Namespace")
-            CASE_FIELDNAME(NEM_STR_PARENT_NAMESPACE, "Parent Name")
-            CASE_FIELDNAME(NEM_STR_ROOT_NAMESPACE, "Create new root")
-            CASE_FIELDNAME(NEM_STR_MOSAIC, "Mosaic Name")
-            CASE_FIELDNAME(NEM_STR_DESCRIPTION, "Description")
-            CASE_FIELDNAME(NEM_STR_LEVY_MOSAIC, "Levy Mosaic")
-        }
+void resolve_fieldname(const field_t *field, char* dst) {
+    uint8_t position = field_position(field);
+    if (position == NEM_FIELD_COUNT) {
+        snprintf(dst, MAX_FIELDNAME_LEN, "Unknown Field");
+    } else if (FIELD_LABELS[position] != NULL) {
+        snprintf(dst, MAX_FIELDNAME_LEN, "%s", (const char *) PIC(FIELD_LABELS[position]));
+    } else {
+        // Property: field->data = len name, name, len value, value (ignore field->length)
+        snprintf_ascii(dst, 0, MAX_FIELDNAME_LEN, field->data + sizeof(uint32_t), read_uint32(field->data));
     }
-
-    // Default case
-    snprintf(dst, MAX_FIELDNAME_LEN, "Unknown Field");
 }
@@ -80,6 +80,7 @@
 #define NEM_STR_LEVY_MOSAIC 0x9B
 #define NEM_STR_LEVY_ADDRESS 0x9C
 #define NEM_STR_TRANSFER_MOSAIC 0x9D
+#define NEM_STR_RECIPIENT_CONTACT 0x9E
 
 // Hash defines
 #define NEM_HASH256 0xB0
@@ -90,6 +91,8 @@
 #define NEM_MOSAIC_CREATE_SUPPLY_DELTA 0xD2
 #define NEM_MOSAIC_DELETE_SUPPLY_DELTA 0xD3
 #define NEM_MOSAIC_UNKNOWN_TYPE 0xD4
+#define NEM_MOSAIC_KNOWN_UNITS 0xD5
+#define NEM_MOSAIC_LEVY 0xD6
 
 typedef struct {
     uint8_t id;
@@ -98,8 +101,60 @@ typedef struct {
     const uint8_t *data;
 } field_t;
 
-// Simple macro for building more readable switch statements
-#define CASE_FIELDNAME(v,src) case v: snprintf(dst, MAX_FIELDNAME_LEN, "%s", src); return;
+// Schema of the displayed fields, one line per field id:
+// FIELD(id, data type, label, formatter, names of the values)
+// Labels are NULL when read from the field, formatters NULL for addresses and known mosaics (see format.c)
+#define NEM_FIELD_SCHEMA(FIELD) \
+    FIELD(NEM_UINT32_TRANSACTION_TYPE, STI_UINT32, "Transaction Type", enum_formatter, TRANSACTION_TYPE_VALUES) \
+    FIELD(NEM_UINT32_INNER_TRANSACTION_TYPE, STI_UINT32, "Inner TX Type", enum_formatter, TRANSACTION_TYPE_VALUES) \
+    FIELD(NEM_UINT32_DETAIL_TRANSACTION_TYPE, STI_UINT32, "Detail TX Type", enum_formatter, TRANSACTION_TYPE_VALUES) \
+    FIELD(NEM_UINT32_AM_MODICATION_TYPE, STI_UINT32, "Mod. Type", enum_formatter, MODIFICATION_TYPE_VALUES) \
+    FIELD(NEM_UINT32_AM_RELATIVE_CHANGE, STI_UINT32, "Relative Change", enum_formatter, RELATIVE_CHANGE_VALUES) \
+    FIELD(NEM_UINT32_AM_COSIGNATORY_NUM, STI_UINT32, "Cosignatory Num", uint32_formatter, NULL) \
+    FIELD(NEM_UINT32_IT_MODE, STI_UINT32, "Importance Mode", enum_formatter, IMPORTANCE_MODE_VALUES) \
+    FIELD(NEM_UINT32_MOSAIC_COUNT, STI_UINT32, "Mosaics", mosaic_count_formatter, NULL) \
+    FIELD(NEM_UINT32_LEVY_FEE_TYPE, STI_UINT32, "Levy Fee Type", enum_formatter, LEVY_FEE_TYPE_VALUES) \
+    FIELD(NEM_UINT64_TXN_FEE, STI_NEM, "Fee", xem_formatter, NULL) \
+    FIELD(NEM_UINT64_MULTISIG_FEE, STI_NEM, "Multisig Fee", xem_formatter, NULL) \
+    FIELD(NEM_UINT64_DURATION, STI_UINT64, "Duration", duration_formatter, NULL) \
+    FIELD(NEM_UINT64_RENTAL_FEE, STI_NEM, "Rental Fee", xem_formatter, NULL) \
+    FIELD(NEM_UINT64_LEVY_FEE, STI_NEM, "Levy Fee", levy_fee_formatter, NULL) \
+    FIELD(NEM_PUBLICKEY_IT_REMOTE, STI_ADDRESS, "Rmt. Address", NULL, NULL) \
+    FIELD(NEM_PUBLICKEY_AM_COSIGNATORY, STI_ADDRESS, "CosignatoryAddr", NULL, NULL) \
+    FIELD(NEM_STR_RECIPIENT_ADDRESS, STI_ADDRESS, "Recipient", NULL, NULL) \
+    FIELD(NEM_STR_RECIPIENT_CONTACT, STI_ADDRESS, "Recipient", NULL, NULL) \
+    FIELD(NEM_STR_TXN_MESSAGE, STI_MESSAGE, "Message", msg_formatter, NULL) \
+    FIELD(NEM_STR_ENC_MESSAGE, STI_MESSAGE, "Message", msg_formatter, NULL) \
+    FIELD(NEM_STR_MULTISIG_ADDRESS, STI_ADDRESS, "Multisig Address", NULL, NULL) \
+    FIELD(NEM_STR_NAMESPACE, STI_STR, "Namespace", string_formatter, NULL) \
+    FIELD(NEM_STR_PARENT_NAMESPACE, STI_STR, "Parent Name", string_formatter, NULL) \
+    FIELD(NEM_STR_ROOT_NAMESPACE, STI_STR, "Create new root", root_namespace_formatter, NULL) \
+    FIELD(NEM_STR_SINK_ADDRESS, STI_ADDRESS, "Sink Address", NULL, NULL) \
+    FIELD(NEM_STR_MOSAIC, STI_STR, "Mosaic Name", string_formatter, NULL) \
+    FIELD(NEM_STR_DESCRIPTION, STI_STR, "Description", string_formatter, NULL) \
+    FIELD(NEM_STR_PROPERTY, STI_PROPERTY, NULL, property_formatter, NULL) \
+    FIELD(NEM_STR_LEVY_MOSAIC, STI_STR, "Levy Mosaic", mosaic_id_formatter, NULL) \
+    FIELD(NEM_STR_LEVY_ADDRESS, STI_ADDRESS, "Levy Address", NULL, NULL) \
+    FIELD(NEM_STR_TRANSFER_MOSAIC, STI_STR, "Namespace", mosaic_id_formatter, NULL) \
+    FIELD(NEM_HASH256, STI_HASH256, "SHA3 Tx Hash", hash_formatter, NULL) \
+    FIELD(NEM_MOSAIC_AMOUNT, STI_NEM, "Amount", xem_formatter, NULL) \
+    FIELD(NEM_MOSAIC_UNITS, STI_MOSAIC_CURRENCY, "Micro Units", NULL, NULL) \
+    FIELD(NEM_MOSAIC_CREATE_SUPPLY_DELTA, STI_MOSAIC_CURRENCY, "Create Supply", supply_formatter, NULL) \
+    FIELD(NEM_MOSAIC_DELETE_SUPPLY_DELTA, STI_MOSAIC_CURRENCY, "Delete Supply", supply_formatter, NULL) \
+    FIELD(NEM_MOSAIC_UNKNOWN_TYPE, STI_STR, "Unknown Mosaic", unknown_mosaic_formatter, NULL) \
+    FIELD(NEM_MOSAIC_KNOWN_UNITS, STI_MOSAIC_CURRENCY, "Amount", NULL, NULL) \
+    FIELD(NEM_MOSAIC_LEVY, STI_MOSAIC_CURRENCY, "Levy", NULL, NULL)
+
+// Position of the fields in the schema tables
+#define FIELD_POSITION(id, dataType, label, formatter, values) FIELD_POSITION_##id,
+enum {
+    NEM_FIELD_SCHEMA(FIELD_POSITION)
+    NEM_FIELD_COUNT
+};
+#undef FIELD_POSITION
+
+// Position of the field in the schema tables, NEM_FIELD_COUNT for unknown fields
+uint8_t field_position(const field_t *field);
 
 void resolve_fieldname(const field_t *field, char* dst);
 
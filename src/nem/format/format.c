@@ -23,118 +23,196 @@
 #include "readers.h"
 #include "printers.h"
 #include "nem_helpers.h"
-#include "apdu/global.h"
+#include "mosaics.h"
+#include "contacts.h"
 #include "common.h"
 #include "base32.h"
 
 typedef void (*field_formatter_t)(const field_t *field, char* dst);
 
-static void uint8_formatter(const field_t *field, char *dst) {
-    uint8_t value = read_uint8(field->data);
-    SNPRINTF(dst, "%d", value);
-}
+typedef struct field_value_t {
+    uint32_t value;
+    const char *name;
+} field_value_t;
+
+typedef struct field_format_t {
+    field_formatter_t formatter;
+    // Names of the values of enum fields
+    const field_value_t *values;
+} field_format_t;
+
+// Ends the names of an enum, with the name of the other values (NULL to show the number)
+#define OTHER_VALUES 0xFFFFFFFFu
+
+static const field_value_t TRANSACTION_TYPE_VALUES[] = {
+    {NEM_TXN_TRANSFER, "Transfer TX"},
+    {NEM_TXN_IMPORTANCE_TRANSFER, "Importance Transfer TX"},
+    {NEM_TXN_MULTISIG_AGGREGATE_MODIFICATION, "Modify Multisig Aggregate TX"},
+    {NEM_TXN_MULTISIG_SIGNATURE, "Multi Sig. TX"},
+    {NEM_TXN_MULTISIG, "Multisig TX"},
+    {NEM_TXN_PROVISION_NAMESPACE, "Provision Namespace TX"},
+    {NEM_TXN_MOSAIC_DEFINITION, "Mosaic Definition TX"},
+    {NEM_TXN_MOSAIC_SUPPLY_CHANGE, "Mosaic Supply Change"},
+    {OTHER_VALUES, "Unknown"}
+};
+
+static const field_value_t MODIFICATION_TYPE_VALUES[] = {
+    {1, "Add cosignatory"},
+    {2, "Delete cosign."},
+    {OTHER_VALUES, ""}
+};
+
+static const field_value_t RELATIVE_CHANGE_VALUES[] = {
+    {0, "Not change"},
+    {OTHER_VALUES, NULL}
+};
+
+static const field_value_t IMPORTANCE_MODE_VALUES[] = {
+    {1, "Activate"},
+    {2, "Deactivate"},
+    {OTHER_VALUES, ""}
+};
+
+static const field_value_t LEVY_FEE_TYPE_VALUES[] = {
+    {1, "Absolute"},
+    {OTHER_VALUES, "Percentile"}
+};
+
+static const field_format_t *get_format(const field_t *field);
 
 static void uint32_formatter(const field_t *field, char *dst) {
+    SNPRINTF(dst, "%d", read_uint32(field->data));
+}
+
+static void enum_formatter(const field_t *field, char *dst) {
     uint32_t value = read_uint32(field->data);
-    if (field->id == NEM_UINT32_MOSAIC_COUNT) {
-        SNPRINTF(dst, "Found %d", value);
-    } else if (field->id == NEM_UINT32_TRANSACTION_TYPE ||
-               field->id == NEM_UINT32_INNER_TRANSACTION_TYPE ||
-               field->id == NEM_UINT32_DETAIL_TRANSACTION_TYPE) {
-        switch (value) {
-            CASE_FIELDVALUE(NEM_TXN_TRANSFER, "Transfer TX")
-            CASE_FIELDVALUE(NEM_TXN_IMPORTANCE_TRANSFER, "Importance Transfer TX")
-            CASE_FIELDVALUE(NEM_TXN_MULTISIG_AGGREGATE_MODIFICATION, "Modify Multisig Aggregate TX")
-            CASE_FIELDVALUE(NEM_TXN_MULTISIG_SIGNATURE, "Multi Sig. TX")
-            CASE_FIELDVALUE(NEM_TXN_MULTISIG, "Multisig TX")
-            CASE_FIELDVALUE(NEM_TXN_PROVISION_NAMESPACE, "Provision Namespace TX")
-            CASE_FIELDVALUE(NEM_TXN_MOSAIC_DEFINITION, "Mosaic Definition TX")
-            CASE_FIELDVALUE(NEM_TXN_MOSAIC_SUPPLY_CHANGE, "Mosaic Supply Change")
-            default:
-                SNPRINTF(dst, "%s", "Unknown");
-        }
-    } else if (field->id == NEM_UINT32_IT_MODE) {
-        if (value == 1) {
-            SNPRINTF(dst, "%s", "Activate");
-        } else if (value == 2) {
-            SNPRINTF(dst, "%s", "Deactivate");
-        }
-    } else if (field->id == NEM_UINT32_AM_MODICATION_TYPE) {
-        if (value == 1) {
-            SNPRINTF(dst, "%s", "Add cosignatory");
-        } else if (value == 2) {
-            SNPRINTF(dst, "%s", "Delete cosign.");
-        }
-    } else if (field->id == NEM_UINT32_AM_RELATIVE_CHANGE) {
-        if (value == 0) {
-            SNPRINTF(dst, "%s", "Not change");
-        } else {
-            SNPRINTF(dst, "%d", value);
-        }
-    } else if (field->id == NEM_UINT32_LEVY_FEE_TYPE) {
-        if (value == 1) {
-            SNPRINTF(dst, "%s", "Absolute");
-        } else {
-            SNPRINTF(dst, "%s", "Percentile");
-        }
+    const field_value_t *values = (const field_value_t *) PIC(get_format(field)->values);
+    while (values->value != value && values->value != OTHER_VALUES) {
+        values++;
+    }
+    if (values->name != NULL) {
+        SNPRINTF(dst, "%s", (const char *) PIC(values->name));
     } else {
         SNPRINTF(dst, "%d", value);
     }
 }
 
-static void uint16_formatter(const field_t *field, char *dst) {
-    uint16_t value = read_uint16(field->data);
-    SNPRINTF(dst, "%x", value);
+static void mosaic_count_formatter(const field_t *field, char *dst) {
+    SNPRINTF(dst, "Found %d", read_uint32(field->data));
 }
 
 static void hash_formatter(const field_t *field, char *dst) {
     snprintf_hex(dst, MAX_FIELD_LEN, field->data, field->length, 0);
 }
 
-static void uint64_formatter(const field_t *field, char *dst) {
-    if (field->id == NEM_UINT64_DURATION) {
-        uint64_t duration = read_uint64(field->data);
-        if (duration == 0) {
-            SNPRINTF(dst, "%s", "Unlimited");
-        } else {
-            uint16_t day = duration / 5760;
-            uint8_t hour = (duration % 5760) / 240;
-            uint8_t min = (duration % 240) / 4;
-            SNPRINTF(dst, "%d%s%d%s%d%s", day, "d ", hour, "h ", min, "m");
-        }
+static void duration_formatter(const field_t *field, char *dst) {
+    uint64_t duration = read_uint64(field->data);
+    if (duration == 0) {
+        SNPRINTF(dst, "%s", "Unlimited");
     } else {
-        snprintf_hex(dst, MAX_FIELD_LEN, field->data, field->length, 1);
+        uint16_t day = duration / 5760;
+        uint8_t hour = (duration % 5760) / 240;
+        uint8_t min = (duration % 240) / 4;
+        SNPRINTF(dst, "%d%s%d%s%d%s", day, "d ", hour, "h ", min, "m");
     }
 }
 
-static void address_formatter(const field_t *field, char *dst) {
+// Needs the network of the transaction, not part of the formatter table
+static void address_formatter(const result_t *result, const field_t *field, char *dst) {
     if (field->id == NEM_PUBLICKEY_IT_REMOTE ||
         field->id == NEM_PUBLICKEY_AM_COSIGNATORY) {
     #ifndef FUZZ
-        nem_public_key_to_address(field->data, transactionContext.network_type, transactionContext.algo , dst, MAX_FIELD_LEN);
+        nem_public_key_to_address(field->data, result->networkType, get_algo(result->networkType), dst, MAX_FIELD_LEN);
+    #else
+        // Addresses need the hash functions of the SDK, show the public key instead
+        (void) result;
+        snprintf_hex(dst, MAX_FIELD_LEN, field->data, field->length, 0);
     #endif
     } else {
-        snprintf_ascii(dst, 0, MAX_FIELD_LEN,field->data, field->length);
+        const char *label = field->id == NEM_STR_RECIPIENT_CONTACT ? find_contact(field->data, field->length) : NULL;
+        if (label != NULL) {
+            SNPRINTF(dst, "%s", label);
+        } else {
+            snprintf_ascii(dst, 0, MAX_FIELD_LEN,field->data, field->length);
+        }
     }
 }
 
-static void mosaic_formatter(const field_t *field, char *dst) {
-    if (field->id == NEM_MOSAIC_CREATE_SUPPLY_DELTA || field->id == NEM_MOSAIC_DELETE_SUPPLY_DELTA) {
-        snprintf_number(dst, MAX_FIELD_LEN, read_uint64(field->data));
+// Amount of a mosaic provided by the host, in the ticker of well-known mosaics or as namespace:name
+static void provided_mosaic_amount(char *dst, uint64_t amount, uint8_t divisibility, const mosaic_id_t *id,
+                                   uint8_t networkType) {
+    char unit[MAX_MOSAIC_NAMESPACE_LEN + MAX_MOSAIC_NAME_LEN + 2];
+    const known_mosaic_t *mosaic = find_known_mosaic((const uint8_t *) id->namespaceId, id->namespaceLength,
+                                                     (const uint8_t *) id->name, id->nameLength, networkType);
+    if (mosaic != NULL) {
+        snprintf(unit, sizeof(unit), "%s", (const char *) PIC(mosaic->ticker));
     } else {
-        //data = mosaic name + amount
-        snprintf_number(dst, MAX_FIELD_LEN, read_uint64(field->data + field->length - 8));
+        snprintf(unit, sizeof(unit), "%.*s:%.*s", id->namespaceLength, id->namespaceId, id->nameLength, id->name);
+    }
+    snprintf_token(dst, MAX_FIELD_LEN, amount, divisibility, unit);
+}
+
+// Levy paid for an amount of the mosaic, in units of the levy mosaic
+static uint64_t levy_amount(const mosaic_metadata_t *metadata, uint64_t amount) {
+    if (metadata->levyType == MOSAIC_LEVY_ABSOLUTE) {
+        return metadata->levyFee;
     }
+    // Percentile fees are at most 10000, split the amount so the product cannot overflow
+    return amount / 10000 * metadata->levyFee + amount % 10000 * metadata->levyFee / 10000;
+}
+
+// Quantity moved by the transfer: data ends with the quantity per 1.000000 of the transfer multiplier
+static uint64_t mosaic_quantity(const result_t *result, const field_t *field) {
+    uint64_t quantity = read_uint64(field->data + field->length - 8);
+    // The parser rejected quantities whose scaled value does not fit
+    scale_mosaic_quantity(quantity, result->mosaicMultiplier, &quantity);
+    return quantity;
 }
 
-static void nem_formatter(const field_t *field, char *dst) {
-    if (field->id == NEM_UINT64_LEVY_FEE) {
-        snprintf_token(dst, MAX_FIELD_LEN, read_uint64(field->data), 6, "micro");
+// Needs the network of the transaction too
+static void known_mosaic_formatter(const result_t *result, const field_t *field, char *dst) {
+    // data = len namespace id, namespace id, len mosaic name, mosaic name, amount
+    uint32_t namespaceLength = read_uint32(field->data);
+    const uint8_t *namespaceId = field->data + sizeof(uint32_t);
+    const uint8_t *name = namespaceId + namespaceLength;
+    uint32_t nameLength = read_uint32(name);
+    uint64_t amount = mosaic_quantity(result, field);
+    const known_mosaic_t *mosaic = find_known_mosaic(namespaceId, namespaceLength, name + sizeof(uint32_t),
+                                                     nameLength, result->networkType);
+    if (mosaic != NULL) {
+        snprintf_token(dst, MAX_FIELD_LEN, amount, mosaic->divisibility, (char *) PIC(mosaic->ticker));
+        return;
+    }
+    const mosaic_metadata_t *metadata = find_provided_mosaic(namespaceId, namespaceLength, name + sizeof(uint32_t),
+                                                             nameLength, result->networkType);
+    if (metadata == NULL) {
+        return;
+    }
+    if (field->id == NEM_MOSAIC_LEVY) {
+        provided_mosaic_amount(dst, levy_amount(metadata, amount), metadata->levyDivisibility, &metadata->levyId,
+                               result->networkType);
     } else {
-        snprintf_token(dst, MAX_FIELD_LEN, read_uint64(field->data), 6, "XEM");
+        provided_mosaic_amount(dst, amount, metadata->divisibility, &metadata->id, result->networkType);
     }
 }
 
+static void supply_formatter(const field_t *field, char *dst) {
+    snprintf_number(dst, MAX_FIELD_LEN, read_uint64(field->data));
+}
+
+static void mosaic_units_formatter(const result_t *result, const field_t *field, char *dst) {
+    //data = mosaic name + amount
+    snprintf_number(dst, MAX_FIELD_LEN, mosaic_quantity(result, field));
+}
+
+static void xem_formatter(const field_t *field, char *dst) {
+    snprintf_token(dst, MAX_FIELD_LEN, read_uint64(field->data), 6, "XEM");
+}
+
+static void levy_fee_formatter(const field_t *field, char *dst) {
+    snprintf_token(dst, MAX_FIELD_LEN, read_uint64(field->data), 6, "micro");
+}
+
 static void msg_formatter(const field_t *field, char *dst) {
     if (field->length == 0) {
         if (field->id == NEM_STR_ENC_MESSAGE) {
@@ -144,8 +222,8 @@ static void msg_formatter(const field_t *field, char *dst) {
         }
     } else {
         if (field->data[0] == 0xFE) { // hex message
-            if (field->length - 1 >= MAX_FIELD_LEN) {
-                snprintf_hex2ascii(dst, MAX_FIELD_LEN, &field->data[1], MAX_FIELD_LEN - 1);
+            if (2 * (field->length - 1) >= MAX_FIELD_LEN) {
+                snprintf_hex2ascii(dst, MAX_FIELD_LEN, &field->data[1], (MAX_FIELD_LEN - 1) / 2);
             } else {
                 snprintf_hex2ascii(dst, MAX_FIELD_LEN, &field->data[1], field->length - 1);
             }
@@ -159,30 +237,36 @@ static void msg_formatter(const field_t *field, char *dst) {
     }
 }
 
+static void unknown_mosaic_formatter(const field_t *field, char *dst) {
+    (void) field;
+    SNPRINTF(dst, "%s", "Divisibility and levy cannot be shown");
+}
+
+static void root_namespace_formatter(const field_t *field, char *dst) {
+    (void) field;
+    SNPRINTF(dst, "%s", "namespace");
+}
+
+static void mosaic_id_formatter(const field_t *field, char *dst) {
+    // Show levy mosaic: namespace:mosaic name
+    // data=len namespace id, namespaceId, len mosaic name, mosaic name
+
+    //read len of namespace id
+    uint32_t nsid_len = read_uint32(field->data);
+    //read namespace id
+    snprintf_ascii(dst, 0, MAX_FIELD_LEN, field->data + sizeof(uint32_t), nsid_len);
+    strcat(dst,": ");
+    //read len of mosaic name
+    uint32_t ms_len = read_uint32(field->data + nsid_len + sizeof(uint32_t));
+    //read mosaic name
+    snprintf_ascii(dst, strlen(dst), MAX_FIELD_LEN, field->data + nsid_len + 2*sizeof(uint32_t) , ms_len);
+}
+
 static void string_formatter(const field_t *field, char *dst) {
-    if (field->id == NEM_MOSAIC_UNKNOWN_TYPE) {
-        SNPRINTF(dst, "%s", "Divisibility and levy cannot be shown");
-    } else if (field->id == NEM_STR_ROOT_NAMESPACE) {
-        SNPRINTF(dst, "%s", "namespace");
-    } else if (field->id == NEM_STR_LEVY_MOSAIC || field->id == NEM_STR_TRANSFER_MOSAIC) {
-        // Show levy mosaic: namespace:mosaic name
-        // data=len namespace id, namespaceId, len mosaic name, mosaic name
-
-        //read len of namespace id
-        uint32_t nsid_len = read_uint32(field->data);
-        //read namespace id
-        snprintf_ascii(dst, 0, MAX_FIELD_LEN, field->data + sizeof(uint32_t), nsid_len);
-        strcat(dst,": ");
-        //read len of mosaic name
-        uint32_t ms_len = read_uint32(field->data + nsid_len + sizeof(uint32_t));
-        //read mosaic name
-        snprintf_ascii(dst, strlen(dst), MAX_FIELD_LEN, field->data + nsid_len + 2*sizeof(uint32_t) , ms_len);
+    if (field->length > MAX_FIELD_LEN) {
+        snprintf_ascii(dst, 0, MAX_FIELD_LEN, field->data, MAX_FIELD_LEN - 1);
     } else {
-        if (field->length > MAX_FIELD_LEN) {
-            snprintf_ascii(dst, 0, MAX_FIELD_LEN, field->data, MAX_FIELD_LEN - 1);
-        } else {
-            snprintf_ascii(dst, 0, MAX_FIELD_LEN, field->data, field->length);
-        }
+        snprintf_ascii(dst, 0, MAX_FIELD_LEN, field->data, field->length);
     }
 }
 
@@ -199,40 +283,27 @@ static void property_formatter(const field_t *field, char *dst) {
     }
 }
 
-static field_formatter_t get_formatter(const field_t *field) {
-    switch (field->dataType) {
-        case STI_UINT8:
-            return uint8_formatter;
-        case STI_UINT16:
-            return uint16_formatter;
-        case STI_UINT32:
-            return uint32_formatter;
-        case STI_UINT64:
-            return uint64_formatter;
-        case STI_HASH256:
-            return hash_formatter;
-        case STI_ADDRESS:
-            return address_formatter;
-        case STI_MOSAIC_CURRENCY:
-            return mosaic_formatter;
-        case STI_NEM:
-            return nem_formatter;
-        case STI_MESSAGE:
-            return msg_formatter;
-        case STI_STR:
-            return string_formatter;
-        case STI_PROPERTY:
-            return property_formatter;
-        default:
-            return NULL;
-    }
-}
-
-void format_field(const field_t *field, char* dst) {
+#define FIELD_FORMAT(id, dataType, label, formatter, values) {formatter, values},
+
+// Indexed by field_position()
+static const field_format_t FIELD_FORMATS[NEM_FIELD_COUNT] = {NEM_FIELD_SCHEMA(FIELD_FORMAT)};
+
+static const field_format_t *get_format(const field_t *field) {
+    uint8_t position = field_position(field);
+    return position == NEM_FIELD_COUNT ? NULL : &FIELD_FORMATS[position];
+}
+
+void format_field(const result_t *result, const field_t *field, char* dst) {
     memset(dst, 0, MAX_FIELD_LEN);
-    field_formatter_t formatter = get_formatter(field);
-    if (formatter != NULL) {
-        formatter(field, dst);
+    const field_format_t *format = get_format(field);
+    if (field->dataType == STI_ADDRESS) {
+        address_formatter(result, field, dst);
+    } else if (field->id == NEM_MOSAIC_KNOWN_UNITS || field->id == NEM_MOSAIC_LEVY) {
+        known_mosaic_formatter(result, field, dst);
+    } else if (field->id == NEM_MOSAIC_UNITS) {
+        mosaic_units_formatter(result, field, dst);
+    } else if (format != NULL && format->formatter != NULL) {
+        ((field_formatter_t) PIC(format->formatter))(field, dst);
     } else {
         SNPRINTF(dst, "%s", "[Not implemented]");
     }
@@ -241,3 +312,76 @@ void format_field(const field_t *field, char* dst) {
         dst[0] = ' ';
     }
 }
+
+static uint8_t is_hex_message(const field_t *field) {
+    return field->length > 0 && field->data[0] == 0xFE;
+}
+
+// Number of characters of a plain or hex message, 0 for other fields
+static uint32_t message_length(const field_t *field) {
+    if (field->dataType != STI_MESSAGE || field->id != NEM_STR_TXN_MESSAGE || field->length == 0) {
+        return 0;
+    }
+    return is_hex_message(field) ? 2 * (field->length - 1) : field->length;
+}
+
+// Characters per window, even so that hex windows hold whole bytes
+static uint32_t window_length(uint32_t length) {
+    uint32_t windowLength = MESSAGE_WINDOW_LEN;
+    if (length > MESSAGE_WINDOW_LEN * MAX_MESSAGE_WINDOWS) {
+        windowLength = (length + MAX_MESSAGE_WINDOWS - 1) / MAX_MESSAGE_WINDOWS;
+        windowLength += windowLength % 2;
+    }
+    return windowLength;
+}
+
+uint8_t format_window_count(const field_t *field) {
+    uint32_t length = message_length(field);
+    if (length <= MESSAGE_WINDOW_LEN) {
+        return 1;
+    }
+    uint32_t windowLength = window_length(length);
+    return (length + windowLength - 1) / windowLength;
+}
+
+void format_window_range(const field_t *field, uint8_t window, uint32_t *offset, uint32_t *length) {
+    uint32_t messageLength = message_length(field);
+    uint32_t windowLength = window_length(messageLength);
+    uint32_t start = window * windowLength;
+    *offset = 0;
+    *length = 0;
+    if (start >= messageLength) {
+        return;
+    }
+    if (messageLength - start < windowLength) {
+        windowLength = messageLength - start;
+    }
+    if (is_hex_message(field)) {
+        *offset = 1 + start / 2;
+        *length = windowLength / 2;
+    } else {
+        *offset = start;
+        *length = windowLength;
+    }
+}
+
+void format_message_window(const field_t *field, const uint8_t *data, uint32_t length, char *dst) {
+    memset(dst, 0, MAX_FIELD_LEN);
+    if (length == 0) {
+        dst[0] = ' ';
+    } else if (is_hex_message(field)) {
+        snprintf_hex2ascii(dst, MAX_FIELD_LEN, data, length);
+    } else {
+        snprintf_ascii(dst, 0, MAX_FIELD_LEN, data, length);
+    }
+}
+
+void format_field_window(const result_t *result, const field_t *field, uint8_t window, char *dst) {
+    uint32_t offset, length;
+    if (format_window_count(field) == 1) {
+        format_field(result, field, dst);
+        return;
+    }
+    format_window_range(field, window, &offset, &length);
+    format_message_window(field, field->data + offset, length, dst);
+}
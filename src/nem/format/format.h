@@ -19,11 +19,20 @@
 #define LEDGER_APP_NEM_FORMAT_H
 
 #include "fields.h"
+#include "nem/parse/nem_parse.h"
 
 #define SNPRINTF(strbuf, ...) snprintf(strbuf, MAX_FIELD_LEN, __VA_ARGS__)
-// Simple macro for building more readable switch statements
-#define CASE_FIELDVALUE(v,src) case v: SNPRINTF(dst, "%s", src); return;
 
-void format_field(const field_t* field, char* dst);
+// field is one of the fields of result
+void format_field(const result_t *result, const field_t* field, char* dst);
+
+// Number of windows needed to review the field, more than 1 for long messages only
+uint8_t format_window_count(const field_t *field);
+// Format one window of the field, only reading the characters of the window in the transaction
+void format_field_window(const result_t *result, const field_t *field, uint8_t window, char *dst);
+// Range of field->data displayed in a window of a message field
+void format_window_range(const field_t *field, uint8_t window, uint32_t *offset, uint32_t *length);
+// Format a window of a message field from the bytes of its range, for messages that are not in the transaction
+void format_message_window(const field_t *field, const uint8_t *data, uint32_t length, char *dst);
 
 #endif //LEDGER_APP_NEM_FORMAT_H
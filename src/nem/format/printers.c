@@ -47,10 +47,9 @@ int snprintf_token(char* dst, uint32_t len, uint64_t amount, uint8_t divisibilit
     char buffer[MAX_FIELD_LEN];
     uint64_t dVal = amount;
     int i, j;
-    uint8_t MAX_DIVISIBILITY = (divisibility == 0) ? 0 : 6;
 
     memset(buffer, 0, MAX_FIELD_LEN);
-    for (i = 0; dVal > 0 || i < MAX_DIVISIBILITY + 1; i++) {
+    for (i = 0; dVal > 0 || i < divisibility + 1; i++) {
         if (dVal > 0) {
             buffer[i] = (dVal % 10) + '0';
             dVal /= 10;
@@ -74,7 +73,7 @@ int snprintf_token(char* dst, uint32_t len, uint64_t amount, uint8_t divisibilit
         dst[j] = buffer[i];
     }
     // strip trailing 0s
-    if (MAX_DIVISIBILITY != 0) {
+    if (divisibility != 0) {
         for (j -= 1; j > 0; j--) {
             if (dst[j] != '0') break;
         }
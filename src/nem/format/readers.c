@@ -22,11 +22,11 @@ uint8_t read_uint8(const uint8_t *src) {
 }
 
 uint16_t read_uint16(const uint8_t *src) {
-    return (uint16_t) *((uint16_t *)src);
+    return (uint16_t) (src[0] | (src[1] << 8));
 }
 
 uint32_t read_uint32(const uint8_t *src) {
-    return (src[3] << 24) | (src[2] << 16) | (src[1] << 8) | src[0];
+    return ((uint32_t) src[3] << 24) | ((uint32_t) src[2] << 16) | ((uint32_t) src[1] << 8) | src[0];
 }
 
 uint64_t read_uint64(const uint8_t *src) {
@@ -0,0 +1,151 @@
+/*******************************************************************************
+*   NEM Wallet
+*   (c) 2020 FDS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include "summary.h"
+#include "format.h"
+#include "readers.h"
+#include "printers.h"
+#include "contacts.h"
+
+// Add a uint64 to a total, reporting an overflow instead of wrapping around
+static int add_amount(uint64_t *total, const field_t *field) {
+    uint64_t value = read_uint64(field->data);
+    if (*total + value < *total) {
+        return E_INVALID_DATA;
+    }
+    *total += value;
+    return E_SUCCESS;
+}
+
+// Messages that need a single screen, longer ones are reviewed window by window
+static bool is_short_message(const field_t *field) {
+    return field->id == NEM_STR_ENC_MESSAGE || format_window_count(field) == 1;
+}
+
+int build_summary(const result_t *result, summary_t *summary) {
+    memset(summary, 0, sizeof(summary_t));
+    summary->result = result;
+    for (uint8_t i = 0; i < result->numFields; i++) {
+        const field_t *field = &result->fields[i];
+        switch (field->id) {
+            case NEM_UINT32_TRANSACTION_TYPE:
+                if (summary->transactionType != NULL ||
+                    (read_uint32(field->data) != NEM_TXN_TRANSFER && read_uint32(field->data) != NEM_TXN_MULTISIG)) {
+                    return E_INVALID_DATA;
+                }
+                summary->transactionType = field;
+                break;
+            case NEM_UINT32_INNER_TRANSACTION_TYPE:
+                if (summary->innerTransactionType != NULL || read_uint32(field->data) != NEM_TXN_TRANSFER) {
+                    return E_INVALID_DATA;
+                }
+                summary->innerTransactionType = field;
+                break;
+            case NEM_STR_RECIPIENT_ADDRESS:
+            case NEM_STR_RECIPIENT_CONTACT:
+                if (summary->recipient != NULL) {
+                    return E_INVALID_DATA;
+                }
+                summary->recipient = field;
+                break;
+            case NEM_MOSAIC_AMOUNT:
+                // Other mosaics, their levies and their supply are only shown by the full review
+                if (field->dataType != STI_NEM || add_amount(&summary->amount, field) != E_SUCCESS) {
+                    return E_INVALID_DATA;
+                }
+                summary->hasAmount = 1;
+                break;
+            case NEM_UINT32_MOSAIC_COUNT:
+                break;
+            case NEM_STR_TXN_MESSAGE:
+            case NEM_STR_ENC_MESSAGE:
+                if (summary->message != NULL || !is_short_message(field)) {
+                    return E_INVALID_DATA;
+                }
+                if (field->id == NEM_STR_ENC_MESSAGE || field->length > 0) {
+                    summary->message = field;
+                }
+                break;
+            case NEM_UINT64_TXN_FEE:
+            case NEM_UINT64_MULTISIG_FEE:
+                if (add_amount(&summary->fee, field) != E_SUCCESS) {
+                    return E_INVALID_DATA;
+                }
+                break;
+            default:
+                // e.g. remote account, cosignatory modifications, levy
+                return E_INVALID_DATA;
+        }
+    }
+    if (summary->transactionType == NULL || summary->recipient == NULL ||
+        (read_uint32(summary->transactionType->data) == NEM_TXN_MULTISIG) != (summary->innerTransactionType != NULL)) {
+        return E_INVALID_DATA;
+    }
+    summary->numPages = summary->message != NULL ? 3 : 2;
+    return E_SUCCESS;
+}
+
+// e.g. "Transfer TX to TBE56Z7MLQZ4S755JZL46VRYM7OD37SLPGFZPO5O", or to the label of the address book
+static void format_destination(const summary_t *summary, char *dst) {
+    uint32_t pos = 0;
+    if (summary->innerTransactionType != NULL) {
+        format_field(summary->result, summary->innerTransactionType, dst);
+        pos = strlen(dst);
+    }
+    if (summary->recipient != NULL) {
+        const field_t *recipient = summary->recipient;
+        const char *label = find_contact(recipient->data, recipient->length);
+        pos += snprintf(dst + pos, MAX_FIELD_LEN - pos, pos == 0 ? "to " : " to ");
+        if (recipient->id == NEM_STR_RECIPIENT_CONTACT && label != NULL) {
+            snprintf(dst + pos, MAX_FIELD_LEN - pos, "%s", label);
+        } else {
+            snprintf_ascii(dst, pos, MAX_FIELD_LEN, recipient->data, recipient->length);
+        }
+    }
+}
+
+// e.g. "5 XEM, fee 0.15 XEM"
+static void format_totals(const summary_t *summary, char *dst) {
+    int pos = 0;
+    memset(dst, 0, MAX_FIELD_LEN);
+    if (summary->hasAmount) {
+        pos = snprintf_token(dst, MAX_FIELD_LEN, summary->amount, 6, "XEM");
+        if (pos < 0) {
+            pos = 0;
+        }
+    }
+    pos += snprintf(dst + pos, MAX_FIELD_LEN - pos, pos == 0 ? "Fee " : ", fee ");
+    snprintf_token(dst + pos, MAX_FIELD_LEN - pos, summary->fee, 6, "XEM");
+}
+
+void format_summary_page(const summary_t *summary, uint8_t page, char *title, char *value) {
+    // Transaction type is the title of the first page
+    format_field(summary->result, summary->transactionType, value);
+    snprintf(title, MAX_FIELDNAME_LEN, "%s", value);
+
+    if (page == 0) {
+        memset(value, 0, MAX_FIELD_LEN);
+        format_destination(summary, value);
+    } else if (page + 1 < summary->numPages) {
+        resolve_fieldname(summary->message, title);
+        format_field(summary->result, summary->message, value);
+    } else {
+        snprintf(title, MAX_FIELDNAME_LEN, "%s", "Total");
+        format_totals(summary, value);
+    }
+}
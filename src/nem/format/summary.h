@@ -0,0 +1,48 @@
+/*******************************************************************************
+*   NEM Wallet
+*   (c) 2020 FDS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+#ifndef LEDGER_APP_NEM_SUMMARY_H
+#define LEDGER_APP_NEM_SUMMARY_H
+
+#include <stdint.h>
+#include "nem/parse/nem_parse.h"
+
+#define SUMMARY_MAX_PAGES 3
+
+typedef struct summary_t {
+    // Summarized transaction, the fields below point into it
+    const result_t *result;
+    const field_t *transactionType;
+    // Inner transaction type of a multisig transaction, if any
+    const field_t *innerTransactionType;
+    const field_t *recipient;
+    // Plain, hex or encrypted message, NULL when empty
+    const field_t *message;
+    // Sum of all XEM amounts (micro nem)
+    uint64_t amount;
+    // Sum of transaction, multisig and rental fees (micro nem)
+    uint64_t fee;
+    uint8_t hasAmount;
+    uint8_t numPages;
+} summary_t;
+
+// Condense the parsed fields into at most SUMMARY_MAX_PAGES pages. Only transfers of XEM,
+// possibly from a multisig account, are summarized: every field must be shown by the summary.
+// Returns E_INVALID_DATA if the transaction cannot be summarized safely.
+int build_summary(const result_t *result, summary_t *summary);
+void format_summary_page(const summary_t *summary, uint8_t page, char *title, char *value);
+
+#endif //LEDGER_APP_NEM_SUMMARY_H
@@ -0,0 +1,79 @@
+/*******************************************************************************
+*   NEM Wallet
+*    (c) 2020 FDS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+#include <string.h>
+#include "mosaics.h"
+#include "nem_helpers.h"
+#ifndef FUZZ
+#include "storage/storage.h"
+#endif
+
+#define MOSAIC(namespaceId, name, ticker, divisibility, networkType) \
+    {namespaceId, name, ticker, sizeof(namespaceId) - 1, sizeof(name) - 1, divisibility, networkType}
+
+#define XEM_SLOT 3
+
+// Each mosaic is in the slot of its hash modulo KNOWN_MOSAIC_SLOTS, no two
+// mosaics share a slot (checked by the tests). Mosaics with a levy are left
+// out, the levy could not be shown.
+static const known_mosaic_t KNOWN_MOSAICS[KNOWN_MOSAIC_SLOTS] = {
+    [1] = MOSAIC("breeze", "breeze-token", "BREEZE", 0, MAINNET),
+    [XEM_SLOT] = MOSAIC(STR_NEM, STR_XEM, "XEM", 6, 0),
+    [6] = MOSAIC("dim", "token", "DIMTOK", 6, MAINNET),
+    [7] = MOSAIC("pacnem", "heart", "PAC:HRT", 0, MAINNET)
+};
+
+uint32_t mosaic_hash(const uint8_t *namespaceId, uint32_t namespaceLength, const uint8_t *name, uint32_t nameLength) {
+    return fnv1a(fnv1a(FNV1A_BASIS, namespaceId, namespaceLength), name, nameLength);
+}
+
+const known_mosaic_t *find_known_mosaic(const uint8_t *namespaceId, uint32_t namespaceLength,
+                                        const uint8_t *name, uint32_t nameLength, uint8_t networkType) {
+    const known_mosaic_t *mosaic =
+        &KNOWN_MOSAICS[mosaic_hash(namespaceId, namespaceLength, name, nameLength) % KNOWN_MOSAIC_SLOTS];
+    if (mosaic->namespaceId == NULL ||
+        mosaic->namespaceLength != namespaceLength || mosaic->nameLength != nameLength ||
+        memcmp(PIC(mosaic->namespaceId), namespaceId, namespaceLength) != 0 ||
+        memcmp(PIC(mosaic->name), name, nameLength) != 0) {
+        return NULL;
+    }
+    if (mosaic->networkType != 0 && mosaic->networkType != networkType) {
+        return NULL;
+    }
+    return mosaic;
+}
+
+const mosaic_metadata_t *find_provided_mosaic(const uint8_t *namespaceId, uint32_t namespaceLength,
+                                              const uint8_t *name, uint32_t nameLength, uint8_t networkType) {
+#ifndef FUZZ
+    return get_cached_mosaic(namespaceId, namespaceLength, name, nameLength, networkType);
+#else
+    (void) namespaceId;
+    (void) namespaceLength;
+    (void) name;
+    (void) nameLength;
+    (void) networkType;
+    return NULL;
+#endif
+}
+
+bool is_xem_mosaic(const known_mosaic_t *mosaic) {
+    return mosaic == &KNOWN_MOSAICS[XEM_SLOT];
+}
+
+const known_mosaic_t *get_known_mosaic(uint8_t slot) {
+    return slot < KNOWN_MOSAIC_SLOTS ? &KNOWN_MOSAICS[slot] : NULL;
+}
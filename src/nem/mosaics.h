@@ -0,0 +1,85 @@
+/*******************************************************************************
+*   NEM Wallet
+*    (c) 2020 FDS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+#ifndef LEDGER_APP_NEM_MOSAICS_H
+#define LEDGER_APP_NEM_MOSAICS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Well-known mosaic, shown as an amount of its ticker
+typedef struct known_mosaic_t {
+    const char *namespaceId;
+    const char *name;
+    const char *ticker;
+    uint8_t namespaceLength;
+    uint8_t nameLength;
+    uint8_t divisibility;
+    // Network the mosaic is defined on, 0 for every network
+    uint8_t networkType;
+} known_mosaic_t;
+
+// Longest ids of the mosaics provided by the host
+#define MAX_MOSAIC_NAMESPACE_LEN 32
+#define MAX_MOSAIC_NAME_LEN 32
+
+// Levy fee types, as in mosaic definitions
+#define MOSAIC_LEVY_NONE 0
+#define MOSAIC_LEVY_ABSOLUTE 1
+#define MOSAIC_LEVY_PERCENTILE 2
+
+typedef struct mosaic_id_t {
+    uint8_t namespaceLength;
+    uint8_t nameLength;
+    char namespaceId[MAX_MOSAIC_NAMESPACE_LEN];
+    char name[MAX_MOSAIC_NAME_LEN];
+} mosaic_id_t;
+
+// Mosaic metadata signed by the metadata key and provided by the host
+typedef struct mosaic_metadata_t {
+    // Increases with every signed metadata of the mosaic, older revisions are not accepted
+    uint32_t revision;
+    uint8_t networkType;
+    uint8_t divisibility;
+    mosaic_id_t id;
+    uint8_t levyType;
+    uint8_t levyDivisibility;
+    mosaic_id_t levyId;
+    // Levy mosaic units, or 1/10000 of the amount for a percentile levy
+    uint64_t levyFee;
+} mosaic_metadata_t;
+
+// Slots of the registry, indexed by the hash of the mosaic id
+#define KNOWN_MOSAIC_SLOTS 8
+
+// FNV-1a of the namespace id followed by the mosaic name
+uint32_t mosaic_hash(const uint8_t *namespaceId, uint32_t namespaceLength, const uint8_t *name, uint32_t nameLength);
+
+// Well-known mosaic defined on the network, NULL for other mosaics
+const known_mosaic_t *find_known_mosaic(const uint8_t *namespaceId, uint32_t namespaceLength,
+                                        const uint8_t *name, uint32_t nameLength, uint8_t networkType);
+
+// Metadata provided by the host for a mosaic of the network, NULL if there is none.
+// Always NULL in host parser builds, which have no NVRAM.
+const mosaic_metadata_t *find_provided_mosaic(const uint8_t *namespaceId, uint32_t namespaceLength,
+                                              const uint8_t *name, uint32_t nameLength, uint8_t networkType);
+
+bool is_xem_mosaic(const known_mosaic_t *mosaic);
+
+// Registry slot, for tests
+const known_mosaic_t *get_known_mosaic(uint8_t slot);
+
+#endif //LEDGER_APP_NEM_MOSAICS_H
@@ -45,7 +45,7 @@ uint8_t get_algo(uint8_t network_type) {
     }
 }
 
-void sha_calculation(uint8_t algorithm, const uint8_t *in, uint8_t inlen, uint8_t *out, uint8_t outlen) {
+void sha_calculation(uint8_t algorithm, const uint8_t *in, uint32_t inlen, uint8_t *out, uint8_t outlen) {
     cx_sha3_t hash;
     if (algorithm == CX_KECCAK) {
         cx_keccak_init(&hash, 256);
@@ -61,27 +61,27 @@ void ripemd(const uint8_t *in, uint8_t inlen, uint8_t *out, uint8_t outlen) {
     cx_hash(&hash.header, CX_LAST, in, inlen, out, outlen);
 }
 
-void nem_public_key_and_address(cx_ecfp_public_key_t *inPublicKey, uint8_t inNetworkId, unsigned int inAlgo, uint8_t *outPublicKey, char *outAddress, uint8_t outLen) {
-    uint8_t buffer1[32];
-    uint8_t buffer2[20];
-    uint8_t rawAddress[32];
-
+void nem_public_key(const cx_ecfp_public_key_t *inPublicKey, uint8_t *outPublicKey) {
     for (uint8_t i=0; i<32; i++) {
         outPublicKey[i] = inPublicKey->W[64 - i];
     }
     if ((inPublicKey->W[32] & 1) != 0) {
         outPublicKey[31] |= 0x80;
     }
-    sha_calculation(inAlgo, outPublicKey, 32, buffer1, sizeof(buffer1));
+}
+
+void nem_raw_address(const uint8_t *inPublicKey, uint8_t inNetworkId, unsigned int inAlgo, uint8_t *outRawAddress) {
+    uint8_t buffer1[32];
+    uint8_t buffer2[20];
+    sha_calculation(inAlgo, inPublicKey, 32, buffer1, sizeof(buffer1));
     ripemd(buffer1, 32, buffer2, sizeof(buffer2));
     //step1: add network prefix char
-    rawAddress[0] = inNetworkId;   //152:,,,,,
+    outRawAddress[0] = inNetworkId;   //152:,,,,,
     //step2: add ripemd160 hash
-    memcpy(rawAddress + 1, buffer2, sizeof(buffer2));
-    sha_calculation(inAlgo, rawAddress, 21, buffer1, sizeof(buffer1));
+    memcpy(outRawAddress + 1, buffer2, sizeof(buffer2));
+    sha_calculation(inAlgo, outRawAddress, 21, buffer1, sizeof(buffer1));
     //step3: add checksum
-    memcpy(rawAddress + 21, buffer1, 4);
-    base32_encode((const uint8_t *) rawAddress, 25, (char *) outAddress, outLen);
+    memcpy(outRawAddress + 21, buffer1, 4);
 }
 
 void nem_get_remote_private_key(const uint8_t *privateKey, unsigned int priKeyLen,
@@ -131,19 +131,9 @@ void nem_get_remote_private_key(const uint8_t *privateKey, unsigned int priKeyLe
     END_TRY;
 }
 
-void nem_public_key_to_address(const uint8_t *inPublicKey, uint8_t inNetworkId, unsigned int inAlgo, char *outAddress, uint8_t outLen) {
-    uint8_t buffer1[32];
-    uint8_t buffer2[20];
-    uint8_t rawAddress[32];
-    sha_calculation(inAlgo, inPublicKey, 32, buffer1, sizeof(buffer1));
-    ripemd(buffer1, 32, buffer2, sizeof(buffer2));
-    //step1: add network prefix char
-    rawAddress[0] = inNetworkId;   //152:,,,,,
-    //step2: add ripemd160 hash
-    memcpy(rawAddress + 1, buffer2, sizeof(buffer2));
-    sha_calculation(inAlgo, rawAddress, 21, buffer1, sizeof(buffer1));
-    //step3: add checksum
-    memcpy(rawAddress + 21, buffer1, 4);
-    base32_encode((const uint8_t *) rawAddress, 25, (char *) outAddress, outLen);
+void nem_public_key_to_address(const uint8_t *inPublicKey, uint8_t inNetworkId, unsigned int inAlgo, char *outAddress, unsigned int outLen) {
+    uint8_t rawAddress[NEM_RAW_ADDRESS_LENGTH];
+    nem_raw_address(inPublicKey, inNetworkId, inAlgo, rawAddress);
+    base32_encode((const uint8_t *) rawAddress, NEM_RAW_ADDRESS_LENGTH, (char *) outAddress, outLen);
 }
 #endif
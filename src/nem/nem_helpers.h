@@ -21,8 +21,12 @@
 #include <os.h>
 #include <cx.h>
 #include <os_io_seproxyhal.h>
+#else
+// Pointers stored in constant tables are relocated on the device only
+#define PIC(x) (x)
 #endif
 #include <stdbool.h>
+#include <stdint.h>
 
 #define NEM_TXN_TRANSFER 0x0101
 #define NEM_TXN_IMPORTANCE_TRANSFER 0x0801
@@ -37,6 +41,7 @@
 #define AMOUNT_MAX_SIZE 21
 #define NEM_ADDRESS_LENGTH 40
 #define NEM_PRETTY_ADDRESS_LENGTH 40
+#define NEM_RAW_ADDRESS_LENGTH 25
 #define NEM_PUBLIC_KEY_LENGTH 32
 #define NEM_PRIVATE_KEY_LENGTH 32
 #define NEM_TRANSACTION_HASH_LENGTH 32
@@ -52,17 +57,59 @@
 #define ACC_KEY     "Export delegated harvesting key?"
 #define ACC_VALUE  "0000000000000000000000000000000000000000000000000000000000000000"
 
+#define FNV1A_BASIS 0x811C9DC5
+
+// FNV-1a, hash of the registries and NVRAM caches indexed by name
+static inline uint32_t fnv1a(uint32_t hash, const uint8_t *data, uint32_t length) {
+    for (uint32_t i = 0; i < length; i++) {
+        hash = (hash ^ data[i]) * 0x01000193;
+    }
+    return hash;
+}
+
+// Big endian value of the responses of the diagnostic commands, returns the offset after it
+static inline uint32_t write_uint32_be(uint8_t *buffer, uint32_t offset, uint32_t value) {
+    buffer[offset++] = value >> 24u;
+    buffer[offset++] = value >> 16u;
+    buffer[offset++] = value >> 8u;
+    buffer[offset++] = value;
+    return offset;
+}
+
+// Amount of a version 2 transfer that moves each mosaic quantity once, other amounts scale them
+#define NEM_TRANSFER_MULTIPLIER_ONE 1000000
+
+// Quantity of a mosaic moved by a version 2 transfer: quantity * multiplier / 1000000.
+// Split the quantity and the multiplier so the products stay in 64 bits, false if the result does not.
+static inline bool scale_mosaic_quantity(uint64_t quantity, uint64_t multiplier, uint64_t *scaled) {
+    uint64_t whole = quantity / NEM_TRANSFER_MULTIPLIER_ONE;
+    uint64_t part = quantity % NEM_TRANSFER_MULTIPLIER_ONE;
+    uint64_t wholeMultiplier = multiplier / NEM_TRANSFER_MULTIPLIER_ONE;
+    uint64_t partMultiplier = multiplier % NEM_TRANSFER_MULTIPLIER_ONE;
+    if ((whole != 0 && multiplier > UINT64_MAX / whole) || (part != 0 && wholeMultiplier > UINT64_MAX / part)) {
+        return false;
+    }
+    uint64_t total = whole * multiplier;
+    uint64_t rest = part * wholeMultiplier + part * partMultiplier / NEM_TRANSFER_MULTIPLIER_ONE;
+    if (rest < part * wholeMultiplier || total + rest < total) {
+        return false;
+    }
+    *scaled = total + rest;
+    return true;
+}
+
 uint8_t get_network_type(const uint32_t bip32Path[]);
 uint8_t get_algo(uint8_t network_type);
 #ifndef FUZZ
-void nem_public_key_and_address(cx_ecfp_public_key_t *inPublicKey, uint8_t inNetworkId, unsigned int inAlgo,
-                                uint8_t *outPublicKey, char *outAddress, uint8_t outLen);
+void sha_calculation(uint8_t algorithm, const uint8_t *in, uint32_t inlen, uint8_t *out, uint8_t outlen);
+void nem_public_key(const cx_ecfp_public_key_t *inPublicKey, uint8_t *outPublicKey);
+void nem_raw_address(const uint8_t *inPublicKey, uint8_t inNetworkId, unsigned int inAlgo, uint8_t *outRawAddress);
 void nem_get_remote_private_key(const uint8_t *privateKey, unsigned int priKeyLen,
                                 const uint8_t *key, unsigned int keyLen,
                                 const uint8_t *value, unsigned int valueLen,
                                 uint8_t encrypt, uint8_t askOnEncrypt, uint8_t askOnDecrypt,
                                 uint8_t *out, unsigned int outLen);
-void nem_public_key_to_address(const uint8_t *inPublicKey, uint8_t inNetworkId, unsigned int inAlgo, char *outAddress, uint8_t outLen);
+void nem_public_key_to_address(const uint8_t *inPublicKey, uint8_t inNetworkId, unsigned int inAlgo, char *outAddress, unsigned int outLen);
 #endif
 
 #endif //LEDGER_APP_NEM_NEMHELPERS_H
@@ -0,0 +1,65 @@
+/*******************************************************************************
+*    NEM Wallet
+*    (c) 2020 FDS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+#ifndef LEDGER_APP_NEM_CURSOR_H
+#define LEDGER_APP_NEM_CURSOR_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Region of the transaction whose bounds were checked once: its values are
+// then read without further checks. Values are little endian and not aligned,
+// they are read byte by byte.
+typedef struct span_t {
+    const uint8_t *data;
+    uint32_t length;
+} span_t;
+
+// Take the length bytes at *offset of data, which holds size bytes (*offset <= size).
+// Returns false, without moving *offset, if they are not all there.
+static inline bool span_take(const uint8_t *data, uint32_t size, uint32_t *offset, uint32_t length, span_t *span) {
+    if (length > size - *offset) {
+        return false;
+    }
+    span->data = data + *offset;
+    span->length = length;
+    *offset += length;
+    return true;
+}
+
+// Next length bytes of a span, the caller knows they are there
+static inline span_t span_next(span_t *span, uint32_t length) {
+    span_t next = {span->data, length};
+    span->data += length;
+    span->length -= length;
+    return next;
+}
+
+static inline uint16_t span_uint16(const span_t *span, uint32_t offset) {
+    const uint8_t *p = span->data + offset;
+    return (uint16_t) (p[0] | (p[1] << 8));
+}
+
+static inline uint32_t span_uint32(const span_t *span, uint32_t offset) {
+    const uint8_t *p = span->data + offset;
+    return (uint32_t) p[0] | ((uint32_t) p[1] << 8) | ((uint32_t) p[2] << 16) | ((uint32_t) p[3] << 24);
+}
+
+static inline uint64_t span_uint64(const span_t *span, uint32_t offset) {
+    return span_uint32(span, offset) | ((uint64_t) span_uint32(span, offset + 4) << 32);
+}
+
+#endif //LEDGER_APP_NEM_CURSOR_H
@@ -16,9 +16,13 @@
 ********************************************************************************/
 
 #include "nem_parse.h"
-#include "apdu/global.h"
+#include "cursor.h"
+#include "nem/mosaics.h"
+#include "nem/contacts.h"
+#include "nem/policy.h"
 #include "nem/format/printers.h"
-#include "nem/format/readers.h"
+#include "perf.h"
+#include "trace.h"
 
 #pragma pack(push, 1)
 
@@ -108,14 +112,98 @@ typedef struct common_txn_header_t {
 #define BAIL_IF(x) {int err = x; if (err) return err;}
 #define BAIL_IF_ERR(x, err) {if (x) return err;}
 
-int parse_multisig_transaction(parse_context_t *context, common_txn_header_t *common_header, uint8_t is_inner_tx);
-
-// Security check
+// Transactions are described by layouts: tables of steps read by parse_layout().
+// Steps read the transaction into marks, which are then shown as fields.
+enum {
+    // Fee of the transaction header, set before the first step
+    M_FEE,
+    M_AMOUNT,
+    M_ADDRESS,
+    M_PUBLIC_KEY,
+    M_HASH,
+    M_COUNT,
+    M_VALUE,
+    M_NAMESPACE,
+    M_NAME,
+    M_MOSAIC_ID,
+    M_MESSAGE,
+    M_IGNORED,
+    LAYOUT_MARKS
+};
+
+typedef enum layout_step_e {
+    // Take a fixed struct of a bytes with one check, the next steps read it whole
+    LAYOUT_BLOCK,
+    // Read a value of a bytes into mark b
+    LAYOUT_VALUE,
+    // Read a length (at most a) and an object of a bytes into mark b, with the length read
+    LAYOUT_OBJECT,
+    // Same as LAYOUT_OBJECT, the object is shown whole
+    LAYOUT_FIXED_OBJECT,
+    // Read a length prefixed string into mark a
+    LAYOUT_STRING,
+    // Read as many bytes as the value of mark a into mark b
+    LAYOUT_BYTES,
+    // Show mark c as a field of id a and type b
+    LAYOUT_FIELD,
+    // Run the next b steps for transactions of version a only
+    LAYOUT_IF_VERSION,
+    // Run the next c steps if the value of mark a is equal, not equal or above the value of the step
+    LAYOUT_IF_EQUAL,
+    LAYOUT_IF_NOT_EQUAL,
+    LAYOUT_IF_ABOVE,
+    // The value of mark a must be between 1 and b
+    LAYOUT_EXPECT_ENUM,
+    // Run the next b steps as many times as the value of mark a
+    LAYOUT_ARRAY,
+    // Read a length into mark a, the next b steps must read exactly that many bytes
+    LAYOUT_SIZED,
+    // Same as LAYOUT_SIZED, the steps are skipped when the length is 0
+    LAYOUT_OPTIONAL,
+    // Run handler a, for what the steps cannot describe
+    LAYOUT_CALL
+} layout_step_e;
+
+typedef struct layout_step_t {
+    uint8_t step;
+    uint8_t a;
+    uint8_t b;
+    uint8_t c;
+    // Compared with the uint32 mark of the LAYOUT_IF_* steps, unused by the others
+    uint32_t value;
+} layout_step_t;
+
+#define L_BLOCK(size)                   {LAYOUT_BLOCK, size, 0, 0, 0}
+#define L_VALUE(size, mark)             {LAYOUT_VALUE, size, mark, 0, 0}
+#define L_OBJECT(size, mark)            {LAYOUT_OBJECT, size, mark, 0, 0}
+#define L_FIXED_OBJECT(size, mark)      {LAYOUT_FIXED_OBJECT, size, mark, 0, 0}
+#define L_STRING(mark)                  {LAYOUT_STRING, mark, 0, 0, 0}
+#define L_BYTES(length, mark)           {LAYOUT_BYTES, length, mark, 0, 0}
+#define L_FIELD(id, type, mark)         {LAYOUT_FIELD, id, type, mark, 0}
+#define L_IF_VERSION(version, count)    {LAYOUT_IF_VERSION, version, count, 0, 0}
+// Any uint32 value, compared unsigned with the mark: a -1 of the transaction is UINT32_MAX
+#define L_IF_EQUAL(mark, value, count)  {LAYOUT_IF_EQUAL, mark, 0, count, value}
+#define L_IF_NOT_EQUAL(mark, value, count) {LAYOUT_IF_NOT_EQUAL, mark, 0, count, value}
+#define L_IF_ABOVE(mark, value, count)  {LAYOUT_IF_ABOVE, mark, 0, count, value}
+#define L_EXPECT_ENUM(mark, max)        {LAYOUT_EXPECT_ENUM, mark, max, 0, 0}
+#define L_ARRAY(mark, count)            {LAYOUT_ARRAY, mark, count, 0, 0}
+#define L_SIZED(mark, count)            {LAYOUT_SIZED, mark, count, 0, 0}
+#define L_OPTIONAL(mark, count)         {LAYOUT_OPTIONAL, mark, count, 0, 0}
+#define L_CALL(handler)                 {LAYOUT_CALL, handler, 0, 0, 0}
+#define L_SHOW_FEE                      L_FIELD(NEM_UINT64_TXN_FEE, STI_NEM, M_FEE)
+
+typedef struct layout_state_t {
+    const common_txn_header_t *header;
+    // Part of the block not read yet
+    span_t block;
+    span_t marks[LAYOUT_MARKS];
+} layout_state_t;
+
+typedef int (*layout_handler_t)(parse_context_t *context, layout_state_t *state);
+
+// Security check, the offset never goes past the length
 static bool has_data(parse_context_t *context, uint32_t numBytes) {
-    if (context->offset + numBytes < context->offset) {
-        return false;
-    }
-    return context->offset + numBytes - 1 < context->length;
+    return numBytes <= context->length - context->offset;
 }
 
 static field_t *get_field(parse_context_t *context, int idx) {
@@ -140,433 +228,455 @@ static int add_new_field(parse_context_t *context, uint8_t id, uint8_t data_type
     return set_field_data(context, context->result.numFields++, id, data_type, length, data);
 }
 
-// Read data and security check
-static const uint8_t* read_data(parse_context_t *context, uint32_t numBytes) {
-    BAIL_IF_ERR(!has_data(context, numBytes), NULL);
-    uint32_t offset = context->offset;
-    context->offset += numBytes;
-#ifdef HAVE_PRINTF
-    PRINTF("******* Read: %d bytes - Move offset: %d->%d/%d\n", numBytes, offset, context->offset, context->length);
-#endif
-    return context->data + offset;
+// Take a span of data and security check
+static bool take_span(parse_context_t *context, uint32_t numBytes, span_t *span) {
+    BAIL_IF_ERR(!span_take(context->data, context->length, &context->offset, numBytes, span), false);
+    TRACE(TRACE_READ, context->offset - numBytes, numBytes);
+    return true;
 }
 
-// Read uint32 and security check
-static int _read_uint32(parse_context_t *context, uint32_t *result) {
-    const uint8_t *p = read_data(context, sizeof(uint32_t));
-    BAIL_IF_ERR(p == NULL, E_NOT_ENOUGH_DATA);
-    *result = read_uint32(p);
-    return E_SUCCESS;
+// Read data and security check
+static const uint8_t* read_data(parse_context_t *context, uint32_t numBytes) {
+    span_t span;
+    BAIL_IF_ERR(!take_span(context, numBytes, &span), NULL);
+    return span.data;
 }
 
-// Read uint32 and security check
-static int _read_uint32_ptr(parse_context_t *context, uint32_t *result, uint8_t **presult) {
-    const uint8_t *p = read_data(context, sizeof(uint32_t));
-    BAIL_IF_ERR(p == NULL, E_NOT_ENOUGH_DATA);
-    *result = read_uint32(p);
-    *presult = (uint8_t *) p;
+// Read into a mark, from the block when there is one, with a security check otherwise
+static inline int read_mark(parse_context_t *context, layout_state_t *state, uint8_t mark, uint32_t numBytes) {
+    if (state->block.length > 0) {
+        // The layouts read blocks whole, the data was checked when the block was taken
+        BAIL_IF_ERR(numBytes > state->block.length, E_INVALID_DATA);
+        state->marks[mark] = span_next(&state->block, numBytes);
+        return E_SUCCESS;
+    }
+    BAIL_IF_ERR(!take_span(context, numBytes, &state->marks[mark]), E_NOT_ENOUGH_DATA);
     return E_SUCCESS;
 }
 
-// Move position and security check
-static const uint8_t* move_pos(parse_context_t *context, uint32_t numBytes) {
-    return read_data(context, numBytes); // Read data and security check
+static uint32_t mark_value(const layout_state_t *state, uint8_t mark) {
+    return span_uint32(&state->marks[mark], 0);
 }
 
-static int parse_transfer_transaction(parse_context_t *context, common_txn_header_t *common_header) {
-    char str[32];
-    const uint8_t *ptr;
-    const uint8_t* startPtr;
-    transfer_txn_header_t *txn = (transfer_txn_header_t *) read_data(context, sizeof(transfer_txn_header_t)); // Read data and security check
-    BAIL_IF_ERR(txn == NULL, E_NOT_ENOUGH_DATA);
-    BAIL_IF_ERR(txn->recipient.length > NEM_ADDRESS_LENGTH, E_INVALID_DATA);
-    // Show Recipient address
-    BAIL_IF(add_new_field(context, NEM_STR_RECIPIENT_ADDRESS, STI_ADDRESS, NEM_ADDRESS_LENGTH, (const uint8_t *) &txn->recipient.address));
-    if (common_header->version == 1) { // NEM tranfer tx version 1
-        // Show xem amount
-        BAIL_IF(add_new_field(context, NEM_MOSAIC_AMOUNT, STI_NEM, sizeof(uint64_t), (const uint8_t *) &txn->amount));
-    }
-    if (txn->msgLen == 0) {
+static int parse_message(parse_context_t *context, layout_state_t *state) {
+    if (mark_value(state, M_MESSAGE) == 0) {
         // empty msg
-        BAIL_IF(add_new_field(context, NEM_STR_TXN_MESSAGE, STI_MESSAGE, txn->msgLen, (const uint8_t *) &txn->msgLen));
+        BAIL_IF(add_new_field(context, NEM_STR_TXN_MESSAGE, STI_MESSAGE, 0, state->marks[M_MESSAGE].data));
     } else {
-        uint32_t payloadType, payloadLength;
-        BAIL_IF(_read_uint32_ptr(context, &payloadType, (uint8_t **) &ptr));
-        BAIL_IF(_read_uint32_ptr(context, &payloadLength, (uint8_t **) &ptr));
-        if (payloadType == 1) {
+        // Payload type and length
+        span_t payload;
+        BAIL_IF_ERR(!take_span(context, 2 * sizeof(uint32_t), &payload), E_NOT_ENOUGH_DATA);
+        uint32_t payloadType = span_uint32(&payload, 0);
+        uint32_t payloadLength = span_uint32(&payload, sizeof(uint32_t));
+        const uint8_t *ptr = payload.data + sizeof(uint32_t);
+        if (payloadType == 1 && payloadLength > 0 && context->pullMessage &&
+            context->transactionType == NEM_TXN_MULTISIG_SIGNATURE) {
+            // The payload is not signed, the host sends it when it is displayed
+            BAIL_IF_ERR(context->pulledField != 0 || payloadLength > MAX_MESSAGE_LEN, E_INVALID_DATA);
+            context->pulledField = context->result.numFields;
+            context->pulledOffset = context->offset;
+            BAIL_IF(add_new_field(context, NEM_STR_TXN_MESSAGE, STI_MESSAGE, payloadLength, ptr));
+        } else if (payloadType == 1) {
             // Show Message
             BAIL_IF(add_new_field(context, NEM_STR_TXN_MESSAGE, STI_MESSAGE, payloadLength, read_data(context, payloadLength))); // Read data and security check
         } else { //show <encrypted msg>
             BAIL_IF(add_new_field(context, NEM_STR_ENC_MESSAGE, STI_MESSAGE, 0, (const uint8_t *) ptr));
-        }
-    }
-    // Show fee
-    BAIL_IF(add_new_field(context, NEM_UINT64_TXN_FEE, STI_NEM, sizeof(uint64_t), (const uint8_t *) &common_header->fee));
-    if (common_header->version == 2) { //NEM tranfer tx version 2
-        // num of mosaic pointer
-        const uint8_t *pnumMosaic;
-        uint32_t numMosaic;
-        BAIL_IF(_read_uint32_ptr(context, &numMosaic, (uint8_t **) &pnumMosaic));
-        if (numMosaic == 0) {
-            // Show xem amount
-            BAIL_IF(add_new_field(context, NEM_UINT64_TXN_FEE, STI_NEM, sizeof(uint64_t), (const uint8_t *) &txn->amount));
-        } else {
-            if (numMosaic > 1) {
-                // Show sent other mosaic num
-                BAIL_IF(add_new_field(context, NEM_UINT32_MOSAIC_COUNT, STI_UINT32, sizeof(uint32_t), (const uint8_t *) pnumMosaic));
-            }
-            for (uint32_t i = 0; i < numMosaic; i++) {
-                // mosaic structure length pointer
-                uint32_t mosaicLen;
-                BAIL_IF(_read_uint32(context, &mosaicLen));
-                BAIL_IF_ERR(!has_data(context, mosaicLen), E_INVALID_DATA);
-                // mosaicId structure length pointer
-                uint32_t mosaicIdLen;
-                BAIL_IF(_read_uint32(context, &mosaicIdLen));
-                BAIL_IF_ERR(!has_data(context, mosaicIdLen), E_INVALID_DATA);
-                BAIL_IF_ERR(mosaicLen - sizeof(uint32_t) - mosaicIdLen - sizeof(uint64_t) != 0, E_INVALID_DATA);
-                // namespaceID length pointer
-                uint32_t nsIdLen;
-                BAIL_IF(_read_uint32_ptr(context, &nsIdLen, (uint8_t **) &startPtr));
-                // namespaceID pointer
-                ptr = read_data(context, nsIdLen); // Read data and security check
-                BAIL_IF_ERR(ptr == NULL, E_NOT_ENOUGH_DATA);
-                snprintf_ascii(str, 0, 32, ptr, nsIdLen);
-                uint8_t is_nem = 0; //namespace is nem
-                if (strcmp(str, STR_NEM) == 0) {
-                    is_nem = 1;
-                }
-                // mosaic name length
-                uint32_t mosaicNameLen;
-                BAIL_IF(_read_uint32(context, &mosaicNameLen))
-                BAIL_IF_ERR(mosaicIdLen - sizeof(uint32_t) - nsIdLen - sizeof(uint32_t) - mosaicNameLen != 0, E_INVALID_DATA);
-                // mosaic name
-                ptr = read_data(context, mosaicNameLen); // Read data and security check
-                BAIL_IF_ERR(ptr == NULL, E_NOT_ENOUGH_DATA);
-                snprintf_ascii(str, 0, 32, ptr, mosaicNameLen);
-                if (is_nem == 1 && strcmp(str, STR_XEM) == 0) {
-                    // xem quantity
-                    BAIL_IF(add_new_field(context, NEM_MOSAIC_AMOUNT, STI_NEM, sizeof(uint64_t), read_data(context, sizeof(uint64_t)))); // Read data and security check
-                } else {
-                    if (numMosaic == 1) {
-                        BAIL_IF(add_new_field(context, NEM_UINT32_MOSAIC_COUNT, STI_UINT32, sizeof(uint32_t), (const uint8_t *) pnumMosaic));
-                    }
-                    // Unknow mosaic notification
-                    BAIL_IF(add_new_field(context, NEM_MOSAIC_UNKNOWN_TYPE, STI_STR, 0, (const uint8_t *) &is_nem));
-                    // Show mosaic information: namespace: mosaic name, data=len namespaceId, namespaceId, len mosaic name, mosaic name
-                    BAIL_IF(add_new_field(context, NEM_STR_TRANSFER_MOSAIC, STI_STR, mosaicIdLen, (const uint8_t *) startPtr));
-                    // Mosaic quantity
-                    BAIL_IF(add_new_field(context, NEM_MOSAIC_UNITS, STI_MOSAIC_CURRENCY, sizeof(uint64_t), read_data(context, sizeof(uint64_t)))); // Read data and security check
-                }
-            }
+            // Skip the encrypted payload, mosaics of version 2 follow it
+            BAIL_IF_ERR(read_data(context, payloadLength) == NULL, E_NOT_ENOUGH_DATA);
         }
     }
     return E_SUCCESS;
 }
 
-static int parse_importance_transfer_transaction(parse_context_t *context, common_txn_header_t *common_header) {
-    importance_txn_header_t *txn = (importance_txn_header_t*) read_data(context, sizeof(importance_txn_header_t)); // Read data and security check
-    BAIL_IF_ERR(txn == NULL, E_NOT_ENOUGH_DATA);
-    BAIL_IF_ERR(txn->iPublicKey.length > NEM_PUBLIC_KEY_LENGTH, E_INVALID_DATA);
-    //  Show importance transfer mode
-    BAIL_IF(add_new_field(context, NEM_UINT32_IT_MODE, STI_UINT32, sizeof(uint8_t), (const uint8_t *) &txn->iMode));
-    // Show public key of remote account
-    BAIL_IF(add_new_field(context, NEM_PUBLICKEY_IT_REMOTE, STI_ADDRESS, NEM_PUBLIC_KEY_LENGTH, (const uint8_t *) &txn->iPublicKey.publicKey));
-    // Show fee
-    BAIL_IF(add_new_field(context, NEM_UINT64_TXN_FEE, STI_NEM, sizeof(uint64_t), (const uint8_t *) &common_header->fee));
-    return E_SUCCESS;
-}
-
-static int parse_aggregate_modification_transaction(parse_context_t *context, common_txn_header_t *common_header) {
-    const uint8_t *pcmNum;
-    uint32_t cmNum;
-    BAIL_IF(_read_uint32_ptr(context, &cmNum, (uint8_t **) &pcmNum));
-    // Show number of cosignatory modification
-    BAIL_IF(add_new_field(context, NEM_UINT32_AM_COSIGNATORY_NUM, STI_UINT32, sizeof(uint32_t), (const uint8_t *) pcmNum));
-    for (uint32_t i = 0; i < cmNum; i++) {
-        aggregate_modication_header_t *txn = (aggregate_modication_header_t*) read_data(context, sizeof(aggregate_modication_header_t)); // Read data and security check
-        BAIL_IF_ERR(txn == NULL, E_NOT_ENOUGH_DATA);
-        BAIL_IF_ERR(txn->amPublicKey.length > NEM_PUBLIC_KEY_LENGTH, E_INVALID_DATA);
-        //  Show modification type
-        BAIL_IF(add_new_field(context, NEM_UINT32_AM_MODICATION_TYPE, STI_UINT32, sizeof(uint32_t), (const uint8_t *) &txn->amType));
-        // Show public key of cosignatory
-        BAIL_IF(add_new_field(context, NEM_PUBLICKEY_AM_COSIGNATORY, STI_ADDRESS, NEM_PUBLIC_KEY_LENGTH, (const uint8_t *) &txn->amPublicKey.publicKey));
+// Fields of a mosaic of a transfer, xem and well-known mosaics are shown as an amount
+static int show_mosaic(parse_context_t *context, layout_state_t *state) {
+    const span_t *marks = state->marks;
+    const known_mosaic_t *mosaic = find_known_mosaic(marks[M_NAMESPACE].data, marks[M_NAMESPACE].length,
+                                                     marks[M_NAME].data, marks[M_NAME].length, context->networkType);
+    const mosaic_metadata_t *metadata = NULL;
+    context->numMosaics++;
+    if (mosaic == NULL) {
+        metadata = find_provided_mosaic(marks[M_NAMESPACE].data, marks[M_NAMESPACE].length,
+                                        marks[M_NAME].data, marks[M_NAME].length, context->networkType);
     }
-    if (common_header->version == 2) {
-        const uint8_t *pcmLen;
-        uint32_t cmLen;
-        BAIL_IF(_read_uint32_ptr(context, &cmLen, (uint8_t **) &pcmLen));
-        if (cmLen > 0) {
-            // Show relative change in minimum cosignatories modification structure
-            const uint8_t *pminCm = read_data(context, sizeof(uint32_t));
-            BAIL_IF_ERR(pminCm==NULL, E_NOT_ENOUGH_DATA);
-            BAIL_IF(add_new_field(context, NEM_UINT32_AM_RELATIVE_CHANGE, STI_UINT32, sizeof(uint32_t), (const uint8_t *) pminCm)); // Read data and security check
-        } else {
-            // Show no minimum cosignatories modification
-            BAIL_IF(add_new_field(context, NEM_UINT32_AM_RELATIVE_CHANGE, STI_UINT32, sizeof(uint32_t), (const uint8_t *) pcmLen));
+    uint64_t multiplier = context->result.mosaicMultiplier;
+    uint64_t quantity;
+    // The network rejects transfers whose moved quantity does not fit
+    BAIL_IF_ERR(!scale_mosaic_quantity(span_uint64(&marks[M_AMOUNT], 0), multiplier, &quantity), E_INVALID_DATA);
+    // data = mosaic id followed by the quantity
+    uint32_t idLength = marks[M_AMOUNT].data + sizeof(uint64_t) - marks[M_MOSAIC_ID].data;
+    if (mosaic != NULL && is_xem_mosaic(mosaic) && multiplier == NEM_TRANSFER_MULTIPLIER_ONE) {
+        // xem quantity, other multipliers show it as a known mosaic whose formatter scales it
+        BAIL_IF(add_new_field(context, NEM_MOSAIC_AMOUNT, STI_NEM, sizeof(uint64_t), marks[M_AMOUNT].data));
+    } else if (mosaic != NULL || metadata != NULL) {
+        BAIL_IF(add_new_field(context, NEM_MOSAIC_KNOWN_UNITS, STI_MOSAIC_CURRENCY, idLength, marks[M_MOSAIC_ID].data));
+        if (metadata != NULL && metadata->levyType != MOSAIC_LEVY_NONE) {
+            BAIL_IF(add_new_field(context, NEM_MOSAIC_LEVY, STI_MOSAIC_CURRENCY, idLength, marks[M_MOSAIC_ID].data));
+        }
+    } else {
+        if (mark_value(state, M_COUNT) == 1) {
+            BAIL_IF(add_new_field(context, NEM_UINT32_MOSAIC_COUNT, STI_UINT32, sizeof(uint32_t), marks[M_COUNT].data));
         }
+        // Unknow mosaic notification
+        BAIL_IF(add_new_field(context, NEM_MOSAIC_UNKNOWN_TYPE, STI_STR, 0, marks[M_NAME].data));
+        // Show mosaic information: namespace: mosaic name, data=len namespaceId, namespaceId, len mosaic name, mosaic name
+        BAIL_IF(add_new_field(context, NEM_STR_TRANSFER_MOSAIC, STI_STR, marks[M_MOSAIC_ID].length, marks[M_MOSAIC_ID].data));
+        // Mosaic quantity
+        BAIL_IF(add_new_field(context, NEM_MOSAIC_UNITS, STI_MOSAIC_CURRENCY, sizeof(uint64_t), marks[M_AMOUNT].data));
     }
-    // Show fee
-    BAIL_IF(add_new_field(context, NEM_UINT64_TXN_FEE, STI_NEM, sizeof(uint64_t), (const uint8_t *) &common_header->fee));
     return E_SUCCESS;
 }
 
-static int parse_multisig_signature_transaction(parse_context_t *context, common_txn_header_t *common_header) {
-    multsig_signature_header_t *txn = (multsig_signature_header_t*) read_data(context, sizeof(multsig_signature_header_t)); // Read data and security check
-    BAIL_IF_ERR(txn == NULL, E_NOT_ENOUGH_DATA);
-    BAIL_IF_ERR(txn->msAddress.length > NEM_ADDRESS_LENGTH, E_INVALID_DATA);
-    BAIL_IF_ERR(txn->hashLen > NEM_TRANSACTION_HASH_LENGTH, E_INVALID_DATA);
-    // Show sha3 hash
-    BAIL_IF(add_new_field(context, NEM_HASH256, STI_HASH256, txn->hashLen, (const uint8_t *) &txn->hash));
-    // Show multisig address
-    BAIL_IF(add_new_field(context, NEM_STR_MULTISIG_ADDRESS, STI_ADDRESS, NEM_ADDRESS_LENGTH, (const uint8_t *) &txn->msAddress.address));
-    // Show multisig signature inner transaction
-    BAIL_IF(parse_multisig_transaction(context, common_header, 0));
+// Amount of a version 2 transfer, read before the mosaics reuse its mark
+static int set_mosaic_multiplier(parse_context_t *context, layout_state_t *state) {
+    context->result.mosaicMultiplier = span_uint64(&state->marks[M_AMOUNT], 0);
     return E_SUCCESS;
 }
 
-static int parse_provision_namespace_transaction(parse_context_t *context, common_txn_header_t *common_header) {
-    rental_header_t *txn = (rental_header_t*) read_data(context, sizeof(rental_header_t)); // Read data and security check
-    BAIL_IF_ERR(txn == NULL, E_NOT_ENOUGH_DATA);
-    BAIL_IF_ERR(txn->rAddress.length > NEM_ADDRESS_LENGTH, E_INVALID_DATA);
-    uint32_t len;
-    BAIL_IF(_read_uint32(context, &len));
-    // New part string
-    BAIL_IF(add_new_field(context, NEM_STR_NAMESPACE, STI_STR, len, read_data(context, len))); // Read data and security check
-    BAIL_IF(_read_uint32(context, &len));
-    if (len == UINT32_MAX) {
-        // Show create new root namespace
-        BAIL_IF(add_new_field(context, NEM_STR_ROOT_NAMESPACE, STI_STR, sizeof(uint32_t), (const uint8_t *) &len));
-    } else {
-        // Show parent namespace string
-        BAIL_IF(add_new_field(context, NEM_STR_PARENT_NAMESPACE, STI_STR, len, read_data(context, len))); // Read data and security check
-    }
-    // Show sink address
-    BAIL_IF(add_new_field(context, NEM_STR_SINK_ADDRESS, STI_ADDRESS, txn->rAddress.length, (const uint8_t *) &txn->rAddress.address));
-    // Show rental fee
-    BAIL_IF(add_new_field(context, NEM_UINT64_RENTAL_FEE, STI_NEM, sizeof(uint64_t), (const uint8_t *) &txn->rentalFee));
-    // Show fee./
-    BAIL_IF(add_new_field(context, NEM_UINT64_TXN_FEE, STI_NEM, sizeof(uint64_t), (const uint8_t *) &common_header->fee));
-    return E_SUCCESS;
+// Recipients of the address book are shown with their label
+static int show_recipient(parse_context_t *context, layout_state_t *state) {
+    const span_t *address = &state->marks[M_ADDRESS];
+    uint8_t id = find_contact(address->data, address->length) != NULL ?
+                 NEM_STR_RECIPIENT_CONTACT : NEM_STR_RECIPIENT_ADDRESS;
+    return add_new_field(context, id, STI_ADDRESS, address->length, address->data);
 }
 
-static int parse_mosaic_definition_creation_transaction(parse_context_t *context, common_txn_header_t *common_header) {
-    const uint8_t* ptr;
-    uint32_t mdsLen;
-    BAIL_IF(_read_uint32(context, &mdsLen));
-    BAIL_IF_ERR(!has_data(context, mdsLen), E_INVALID_DATA);
-    publickey_t* mdcPublicKey = (publickey_t*) read_data(context, sizeof(publickey_t));
-    BAIL_IF_ERR(mdcPublicKey == NULL, E_NOT_ENOUGH_DATA);
-    BAIL_IF_ERR(mdcPublicKey->length > NEM_PUBLIC_KEY_LENGTH, E_INVALID_DATA);
-    //Length of mosaic id structure
-    uint32_t midsLen;
-    BAIL_IF(_read_uint32(context, &midsLen));
-    //Length of namespace id string
-    uint32_t nsIdLen;
-    BAIL_IF(_read_uint32(context, &nsIdLen));
-    // Show namespace id string
-    BAIL_IF(add_new_field(context, NEM_STR_PARENT_NAMESPACE, STI_STR, nsIdLen, read_data(context, nsIdLen))); // Read data and security check
-    // Length of mosaic name string
-    uint32_t mosaicNameLen;
-    BAIL_IF(_read_uint32(context, &mosaicNameLen));
-    BAIL_IF_ERR(midsLen - sizeof(uint32_t) - nsIdLen - sizeof(uint32_t) - mosaicNameLen != 0, E_INVALID_DATA);
-    // Show mosaic name string
-    BAIL_IF(add_new_field(context, NEM_STR_MOSAIC, STI_STR, mosaicNameLen, read_data(context, mosaicNameLen))); // Read data and security check
-    //Length of description string
-    uint32_t desLen;
-    BAIL_IF(_read_uint32(context, &desLen));
-    // Show description string
-    BAIL_IF(add_new_field(context, NEM_STR_DESCRIPTION, STI_STR, desLen, read_data(context, desLen))); // Read data and security check
-    uint32_t propertyNum;
-    BAIL_IF(_read_uint32(context, &propertyNum));
-    uint32_t propertyLen = 0;
-    for (uint32_t i = 0; i < propertyNum; i++) {
-        // Length of the property structure
-        uint32_t proStructLen;
-        BAIL_IF(_read_uint32(context, &proStructLen));
-        BAIL_IF_ERR(!has_data(context, proStructLen), E_INVALID_DATA);
-        // Length of the property name
-        uint32_t proNameLen;
-        BAIL_IF(_read_uint32_ptr(context, &proNameLen, (uint8_t **) &ptr));
-        // Show property name string
-        BAIL_IF_ERR(move_pos(context, proNameLen) == NULL, E_NOT_ENOUGH_DATA);
-        uint32_t proValLen;
-        BAIL_IF(_read_uint32(context, &proValLen));
-        BAIL_IF_ERR(proStructLen - sizeof(uint32_t) - proNameLen - sizeof(uint32_t) - proValLen != 0, E_INVALID_DATA);
-        // Show property value string
-        BAIL_IF_ERR(move_pos(context, proValLen) == NULL, E_NOT_ENOUGH_DATA);
-        // data = len name, name, len value, value (ignore length)
-        BAIL_IF(add_new_field(context, NEM_STR_PROPERTY, STI_PROPERTY, proStructLen, ptr));
-        propertyLen = propertyLen + sizeof(uint32_t) + proStructLen;
-    }
-    // Levy structure length
-    uint32_t levyLen;
-    BAIL_IF(_read_uint32(context, &levyLen));
-    if(levyLen > 0) {
-        BAIL_IF_ERR(!has_data(context, levyLen), E_NOT_ENOUGH_DATA);
-        levy_structure_t *levy = (levy_structure_t*) read_data(context, sizeof(levy_structure_t)); // Read data and security check
-        BAIL_IF_ERR(levy == NULL, E_NOT_ENOUGH_DATA);
-        BAIL_IF_ERR(levy->feeType != 1 && levy->feeType != 2, E_INVALID_DATA);
-        BAIL_IF_ERR(levy->lsAddress.length > NEM_ADDRESS_LENGTH, E_INVALID_DATA);
-        BAIL_IF_ERR(levy->msIdLen > mdsLen, E_INVALID_DATA);
-        ptr = read_data(context, sizeof(uint32_t)); // Read data and security check
-        BAIL_IF_ERR(ptr == NULL, E_NOT_ENOUGH_DATA);
-        //Length of namespace id string
-        uint32_t nsidLen = read_uint32(ptr);
-        //namespaceid
-        BAIL_IF_ERR(move_pos(context, nsidLen) == NULL, E_NOT_ENOUGH_DATA);
-        uint32_t mnLen;
-        BAIL_IF(_read_uint32(context, &mnLen));
-        BAIL_IF_ERR(levy->msIdLen - sizeof(uint32_t) - nsidLen - sizeof(uint32_t) - mnLen != 0, E_INVALID_DATA);
-        BAIL_IF_ERR(levyLen - sizeof(levy_structure_t) - levy->msIdLen - sizeof(uint64_t) != 0, E_INVALID_DATA);
-        //mosaic name
-        BAIL_IF_ERR(move_pos(context, mnLen) == NULL, E_NOT_ENOUGH_DATA);
-        // Show levy mosaic: namespace: mosaic name, data = len namespaceid, namespaceid, len mosaic name, mosaic name
-        BAIL_IF(add_new_field(context, NEM_STR_LEVY_MOSAIC, STI_STR, levy->msIdLen, (const uint8_t *) ptr));
-        // Show levy address
-        BAIL_IF(add_new_field(context, NEM_STR_LEVY_ADDRESS, STI_ADDRESS, NEM_ADDRESS_LENGTH, (const uint8_t *) &levy->lsAddress.address));
-        // Show levy fee type
-        BAIL_IF(add_new_field(context, NEM_UINT32_LEVY_FEE_TYPE, STI_UINT32, sizeof(uint32_t), (const uint8_t *) &levy->feeType));
-        // Show levy fee
-        BAIL_IF(add_new_field(context, NEM_UINT64_LEVY_FEE, STI_NEM, sizeof(uint64_t), read_data(context, sizeof(uint64_t)))); // Read data and security check
+static int parse_inner_transactions(parse_context_t *context, layout_state_t *state);
+
+enum {
+    H_MESSAGE,
+    H_MOSAIC,
+    H_MULTIPLIER,
+    H_RECIPIENT,
+    H_INNER_TRANSACTIONS
+};
+
+static const layout_handler_t LAYOUT_HANDLERS[] = {
+    parse_message,
+    show_mosaic,
+    set_mosaic_multiplier,
+    show_recipient,
+    parse_inner_transactions
+};
+
+static const layout_step_t TRANSFER_LAYOUT[] = {
+    L_BLOCK(sizeof(transfer_txn_header_t)),
+    L_FIXED_OBJECT(NEM_ADDRESS_LENGTH, M_ADDRESS),
+    L_CALL(H_RECIPIENT),
+    L_VALUE(sizeof(uint64_t), M_AMOUNT),
+    L_IF_VERSION(1, 1),
+        L_FIELD(NEM_MOSAIC_AMOUNT, STI_NEM, M_AMOUNT),
+    L_VALUE(sizeof(uint32_t), M_MESSAGE),
+    L_CALL(H_MESSAGE),
+    L_SHOW_FEE,
+    L_IF_VERSION(2, 13),
+        L_CALL(H_MULTIPLIER),
+        L_VALUE(sizeof(uint32_t), M_COUNT),
+        L_IF_EQUAL(M_COUNT, 0, 1),
+            L_FIELD(NEM_MOSAIC_AMOUNT, STI_NEM, M_AMOUNT),
+        L_IF_ABOVE(M_COUNT, 1, 1),
+            L_FIELD(NEM_UINT32_MOSAIC_COUNT, STI_UINT32, M_COUNT),
+        L_ARRAY(M_COUNT, 6),
+            L_SIZED(M_IGNORED, 5),
+                L_SIZED(M_MOSAIC_ID, 2),
+                    L_STRING(M_NAMESPACE),
+                    L_STRING(M_NAME),
+                L_VALUE(sizeof(uint64_t), M_AMOUNT),
+                L_CALL(H_MOSAIC)
+};
+
+static const layout_step_t IMPORTANCE_TRANSFER_LAYOUT[] = {
+    L_BLOCK(sizeof(importance_txn_header_t)),
+    L_VALUE(sizeof(uint32_t), M_VALUE),
+    L_FIXED_OBJECT(NEM_PUBLIC_KEY_LENGTH, M_PUBLIC_KEY),
+    L_FIELD(NEM_UINT32_IT_MODE, STI_UINT32, M_VALUE),
+    L_FIELD(NEM_PUBLICKEY_IT_REMOTE, STI_ADDRESS, M_PUBLIC_KEY),
+    L_SHOW_FEE
+};
+
+static const layout_step_t AGGREGATE_MODIFICATION_LAYOUT[] = {
+    L_VALUE(sizeof(uint32_t), M_COUNT),
+    L_FIELD(NEM_UINT32_AM_COSIGNATORY_NUM, STI_UINT32, M_COUNT),
+    L_ARRAY(M_COUNT, 6),
+        L_BLOCK(sizeof(aggregate_modication_header_t)),
+        L_VALUE(sizeof(uint32_t), M_IGNORED),
+        L_VALUE(sizeof(uint32_t), M_VALUE),
+        L_FIXED_OBJECT(NEM_PUBLIC_KEY_LENGTH, M_PUBLIC_KEY),
+        L_FIELD(NEM_UINT32_AM_MODICATION_TYPE, STI_UINT32, M_VALUE),
+        L_FIELD(NEM_PUBLICKEY_AM_COSIGNATORY, STI_ADDRESS, M_PUBLIC_KEY),
+    // Minimum cosignatories modification
+    L_IF_VERSION(2, 6),
+        L_VALUE(sizeof(uint32_t), M_VALUE),
+        L_IF_EQUAL(M_VALUE, 0, 1),
+            L_FIELD(NEM_UINT32_AM_RELATIVE_CHANGE, STI_UINT32, M_VALUE),
+        L_IF_NOT_EQUAL(M_VALUE, 0, 2),
+            L_VALUE(sizeof(uint32_t), M_VALUE),
+            L_FIELD(NEM_UINT32_AM_RELATIVE_CHANGE, STI_UINT32, M_VALUE),
+    L_SHOW_FEE
+};
+
+static const layout_step_t MULTISIG_SIGNATURE_LAYOUT[] = {
+    L_BLOCK(sizeof(multsig_signature_header_t)),
+    L_VALUE(sizeof(uint32_t), M_IGNORED),
+    L_OBJECT(NEM_TRANSACTION_HASH_LENGTH, M_HASH),
+    L_FIXED_OBJECT(NEM_ADDRESS_LENGTH, M_ADDRESS),
+    L_FIELD(NEM_HASH256, STI_HASH256, M_HASH),
+    L_FIELD(NEM_STR_MULTISIG_ADDRESS, STI_ADDRESS, M_ADDRESS),
+    L_CALL(H_INNER_TRANSACTIONS)
+};
+
+static const layout_step_t MULTISIG_LAYOUT[] = {
+    L_CALL(H_INNER_TRANSACTIONS)
+};
+
+static const layout_step_t PROVISION_NAMESPACE_LAYOUT[] = {
+    L_BLOCK(sizeof(rental_header_t)),
+    L_OBJECT(NEM_ADDRESS_LENGTH, M_ADDRESS),
+    L_VALUE(sizeof(uint64_t), M_AMOUNT),
+    L_STRING(M_NAMESPACE),
+    L_FIELD(NEM_STR_NAMESPACE, STI_STR, M_NAMESPACE),
+    // Length of the parent namespace, 0xFFFFFFFF (-1) for a root namespace
+    L_VALUE(sizeof(uint32_t), M_VALUE),
+    L_IF_EQUAL(M_VALUE, UINT32_MAX, 1),
+        L_FIELD(NEM_STR_ROOT_NAMESPACE, STI_STR, M_VALUE),
+    L_IF_NOT_EQUAL(M_VALUE, UINT32_MAX, 2),
+        L_BYTES(M_VALUE, M_NAMESPACE),
+        L_FIELD(NEM_STR_PARENT_NAMESPACE, STI_STR, M_NAMESPACE),
+    L_FIELD(NEM_STR_SINK_ADDRESS, STI_ADDRESS, M_ADDRESS),
+    L_FIELD(NEM_UINT64_RENTAL_FEE, STI_NEM, M_AMOUNT),
+    L_SHOW_FEE
+};
+
+static const layout_step_t MOSAIC_DEFINITION_LAYOUT[] = {
+    L_SIZED(M_IGNORED, 27),
+        // Creator
+        L_FIXED_OBJECT(NEM_PUBLIC_KEY_LENGTH, M_PUBLIC_KEY),
+        L_SIZED(M_MOSAIC_ID, 4),
+            L_STRING(M_NAMESPACE),
+            L_FIELD(NEM_STR_PARENT_NAMESPACE, STI_STR, M_NAMESPACE),
+            L_STRING(M_NAME),
+            L_FIELD(NEM_STR_MOSAIC, STI_STR, M_NAME),
+        L_STRING(M_NAME),
+        L_FIELD(NEM_STR_DESCRIPTION, STI_STR, M_NAME),
+        L_VALUE(sizeof(uint32_t), M_COUNT),
+        L_ARRAY(M_COUNT, 4),
+            // data = len name, name, len value, value
+            L_SIZED(M_VALUE, 2),
+                L_STRING(M_NAME),
+                L_STRING(M_NAME),
+            L_FIELD(NEM_STR_PROPERTY, STI_PROPERTY, M_VALUE),
+        // Levy
+        L_OPTIONAL(M_IGNORED, 12),
+            L_BLOCK(sizeof(levy_structure_t)),
+            L_VALUE(sizeof(uint32_t), M_VALUE),
+            L_EXPECT_ENUM(M_VALUE, 2),
+            L_FIXED_OBJECT(NEM_ADDRESS_LENGTH, M_ADDRESS),
+            L_SIZED(M_MOSAIC_ID, 2),
+                L_STRING(M_NAMESPACE),
+                L_STRING(M_NAME),
+            L_FIELD(NEM_STR_LEVY_MOSAIC, STI_STR, M_MOSAIC_ID),
+            L_FIELD(NEM_STR_LEVY_ADDRESS, STI_ADDRESS, M_ADDRESS),
+            L_FIELD(NEM_UINT32_LEVY_FEE_TYPE, STI_UINT32, M_VALUE),
+            L_VALUE(sizeof(uint64_t), M_AMOUNT),
+            L_FIELD(NEM_UINT64_LEVY_FEE, STI_NEM, M_AMOUNT),
+    L_BLOCK(sizeof(mosaic_definition_sink_t)),
+    L_FIXED_OBJECT(NEM_ADDRESS_LENGTH, M_ADDRESS),
+    L_VALUE(sizeof(uint64_t), M_AMOUNT),
+    L_FIELD(NEM_STR_SINK_ADDRESS, STI_ADDRESS, M_ADDRESS),
+    L_FIELD(NEM_UINT64_RENTAL_FEE, STI_NEM, M_AMOUNT),
+    L_SHOW_FEE
+};
+
+static const layout_step_t MOSAIC_SUPPLY_CHANGE_LAYOUT[] = {
+    L_SIZED(M_MOSAIC_ID, 4),
+        L_STRING(M_NAMESPACE),
+        L_FIELD(NEM_STR_NAMESPACE, STI_STR, M_NAMESPACE),
+        L_STRING(M_NAME),
+        L_FIELD(NEM_STR_MOSAIC, STI_STR, M_NAME),
+    // Supply type and delta
+    L_VALUE(sizeof(uint32_t), M_VALUE),
+    L_EXPECT_ENUM(M_VALUE, 2),
+    L_VALUE(sizeof(uint64_t), M_AMOUNT),
+    L_IF_EQUAL(M_VALUE, 1, 1),
+        L_FIELD(NEM_MOSAIC_CREATE_SUPPLY_DELTA, STI_MOSAIC_CURRENCY, M_AMOUNT),
+    L_IF_EQUAL(M_VALUE, 2, 1),
+        L_FIELD(NEM_MOSAIC_DELETE_SUPPLY_DELTA, STI_MOSAIC_CURRENCY, M_AMOUNT),
+    L_SHOW_FEE
+};
+
+typedef struct transaction_layout_t {
+    uint32_t transactionType;
+    const layout_step_t *steps;
+    uint8_t numSteps;
+} transaction_layout_t;
+
+#define LAYOUT(type, steps) {type, steps, sizeof(steps) / sizeof(layout_step_t)}
+
+static const transaction_layout_t TRANSACTION_LAYOUTS[] = {
+    LAYOUT(NEM_TXN_TRANSFER, TRANSFER_LAYOUT),
+    LAYOUT(NEM_TXN_IMPORTANCE_TRANSFER, IMPORTANCE_TRANSFER_LAYOUT),
+    LAYOUT(NEM_TXN_MULTISIG_AGGREGATE_MODIFICATION, AGGREGATE_MODIFICATION_LAYOUT),
+    LAYOUT(NEM_TXN_MULTISIG_SIGNATURE, MULTISIG_SIGNATURE_LAYOUT),
+    LAYOUT(NEM_TXN_MULTISIG, MULTISIG_LAYOUT),
+    LAYOUT(NEM_TXN_PROVISION_NAMESPACE, PROVISION_NAMESPACE_LAYOUT),
+    LAYOUT(NEM_TXN_MOSAIC_DEFINITION, MOSAIC_DEFINITION_LAYOUT),
+    LAYOUT(NEM_TXN_MOSAIC_SUPPLY_CHANGE, MOSAIC_SUPPLY_CHANGE_LAYOUT)
+};
+
+static int parse_layout(parse_context_t *context, layout_state_t *state, const layout_step_t *steps, uint8_t numSteps) {
+    for (uint8_t i = 0; i < numSteps; i++) {
+        const layout_step_t *step = &steps[i];
+        span_t *marks = state->marks;
+        uint32_t length;
+        switch (step->step) {
+            case LAYOUT_BLOCK:
+                BAIL_IF_ERR(!take_span(context, step->a, &state->block), E_NOT_ENOUGH_DATA);
+                break;
+            case LAYOUT_VALUE:
+                BAIL_IF(read_mark(context, state, step->b, step->a));
+                break;
+            case LAYOUT_OBJECT:
+            case LAYOUT_FIXED_OBJECT:
+                BAIL_IF(read_mark(context, state, step->b, sizeof(uint32_t)));
+                length = mark_value(state, step->b);
+                BAIL_IF_ERR(length > step->a, E_INVALID_DATA);
+                BAIL_IF(read_mark(context, state, step->b, step->a));
+                if (step->step == LAYOUT_OBJECT) {
+                    marks[step->b].length = length;
+                }
+                break;
+            case LAYOUT_STRING:
+                BAIL_IF(read_mark(context, state, step->a, sizeof(uint32_t)));
+                BAIL_IF(read_mark(context, state, step->a, mark_value(state, step->a)));
+                break;
+            case LAYOUT_BYTES:
+                BAIL_IF(read_mark(context, state, step->b, mark_value(state, step->a)));
+                break;
+            case LAYOUT_FIELD:
+                BAIL_IF(add_new_field(context, step->a, step->b, marks[step->c].length, marks[step->c].data));
+                break;
+            case LAYOUT_IF_VERSION:
+                if (state->header->version != step->a) {
+                    i += step->b;
+                }
+                break;
+            case LAYOUT_IF_EQUAL:
+                if (mark_value(state, step->a) != step->value) {
+                    i += step->c;
+                }
+                break;
+            case LAYOUT_IF_NOT_EQUAL:
+                if (mark_value(state, step->a) == step->value) {
+                    i += step->c;
+                }
+                break;
+            case LAYOUT_IF_ABOVE:
+                if (mark_value(state, step->a) <= step->value) {
+                    i += step->c;
+                }
+                break;
+            case LAYOUT_EXPECT_ENUM:
+                length = mark_value(state, step->a);
+                BAIL_IF_ERR(length == 0 || length > step->b, E_INVALID_DATA);
+                break;
+            case LAYOUT_ARRAY:
+                // Every element reads data, the count is bounded by the transaction length
+                for (uint32_t n = mark_value(state, step->a); n > 0; n--) {
+                    BAIL_IF(parse_layout(context, state, step + 1, step->b));
+                }
+                i += step->b;
+                break;
+            case LAYOUT_SIZED:
+            case LAYOUT_OPTIONAL:
+                BAIL_IF(read_mark(context, state, step->a, sizeof(uint32_t)));
+                length = mark_value(state, step->a);
+                marks[step->a].data += sizeof(uint32_t);
+                marks[step->a].length = length;
+                if (length > 0 || step->step == LAYOUT_SIZED) {
+                    uint32_t start = context->offset;
+                    BAIL_IF(parse_layout(context, state, step + 1, step->b));
+                    // Check length of nested objects
+                    BAIL_IF_ERR(context->offset - start != length, E_INVALID_DATA);
+                }
+                i += step->b;
+                break;
+            case LAYOUT_CALL:
+                BAIL_IF(((layout_handler_t) PIC(LAYOUT_HANDLERS[step->a]))(context, state));
+                break;
+            default:
+                return E_INVALID_DATA;
+        }
     }
-    // Check length of nested objects in mosaic definitions
-    BAIL_IF_ERR(mdsLen - sizeof(publickey_t) - sizeof(uint32_t) - midsLen - sizeof(uint32_t) - desLen - sizeof(uint32_t) - propertyLen
-                 - sizeof(uint32_t) - levyLen != 0, E_INVALID_DATA);
-    // Check mosaic definition sink address
-    mosaic_definition_sink_t *sink = (mosaic_definition_sink_t*) read_data(context, sizeof(mosaic_definition_sink_t)); // Read data and security check
-    BAIL_IF_ERR(sink == NULL, E_NOT_ENOUGH_DATA);
-    BAIL_IF_ERR(sink->mdAddress.length > NEM_ADDRESS_LENGTH, E_INVALID_DATA);
-    // Show sink address
-    BAIL_IF(add_new_field(context, NEM_STR_SINK_ADDRESS, STI_ADDRESS, NEM_ADDRESS_LENGTH, (const uint8_t *) &sink->mdAddress.address));
-    // Show rentail fee
-    BAIL_IF(add_new_field(context, NEM_UINT64_RENTAL_FEE, STI_NEM, sizeof(uint64_t), (const uint8_t *) &sink->fee));
-    // Show tx fee
-    BAIL_IF(add_new_field(context, NEM_UINT64_TXN_FEE, STI_NEM, sizeof(uint64_t), (const uint8_t *) &common_header->fee));
     return E_SUCCESS;
 }
 
-static int parse_mosaic_supply_change_transaction(parse_context_t *context, common_txn_header_t *common_header) {
-    //Length of mosaic id structure
-    uint32_t msidLen;
-    BAIL_IF(_read_uint32(context, &msidLen));
-    //Length of namespace id string: 4
-    uint32_t nsidLen;
-    BAIL_IF(_read_uint32(context, &nsidLen));
-    // Show namespace id string
-    BAIL_IF(add_new_field(context, NEM_STR_NAMESPACE, STI_STR, nsidLen, read_data(context, nsidLen))); // Read data and security check
-    //Length of mosaic name string
-    uint32_t msnLen;
-    BAIL_IF(_read_uint32(context, &msnLen));
-    BAIL_IF_ERR(msidLen - sizeof(uint32_t) - nsidLen - sizeof(uint32_t) - msnLen != 0, E_INVALID_DATA);
-    // Show mosaic name string
-    BAIL_IF(add_new_field(context, NEM_STR_MOSAIC, STI_STR, msnLen, read_data(context, msnLen))); // Read data and security check
-    // supply type and delta change
-    uint32_t supplyType;
-    BAIL_IF(_read_uint32(context, &supplyType));
-    if (supplyType == 1) {
-        BAIL_IF(add_new_field(context, NEM_MOSAIC_CREATE_SUPPLY_DELTA, STI_MOSAIC_CURRENCY, sizeof(uint64_t), read_data(context, sizeof(uint64_t)))); // Read data and security check
-    } else if (supplyType == 2) {
-        BAIL_IF(add_new_field(context, NEM_MOSAIC_DELETE_SUPPLY_DELTA, STI_MOSAIC_CURRENCY, sizeof(uint64_t), read_data(context, sizeof(uint64_t)))); // Read data and security check
-    } else {
-        return E_INVALID_DATA;
+static int parse_transaction(parse_context_t *context, const common_txn_header_t *header) {
+    for (uint8_t i = 0; i < sizeof(TRANSACTION_LAYOUTS) / sizeof(transaction_layout_t); i++) {
+        const transaction_layout_t *layout = &TRANSACTION_LAYOUTS[i];
+        if (layout->transactionType == header->transactionType) {
+            layout_state_t state;
+            state.header = header;
+            state.block.length = 0;
+            state.marks[M_FEE].data = (const uint8_t *) &header->fee;
+            state.marks[M_FEE].length = sizeof(uint64_t);
+            return parse_layout(context, &state, (const layout_step_t *) PIC(layout->steps), layout->numSteps);
+        }
     }
-    // Show fee
-    BAIL_IF(add_new_field(context, NEM_UINT64_TXN_FEE, STI_NEM, sizeof(uint64_t), (const uint8_t *) &common_header->fee));
-    return E_SUCCESS;
+    return E_INVALID_DATA;
+}
+
+// Length of the message payload left out of data
+static uint32_t pulled_length(parse_context_t *context) {
+    return context->pulledField == 0 ? 0 : context->result.fields[context->pulledField].length;
 }
 
-int parse_multisig_transaction(parse_context_t *context, common_txn_header_t *common_header, uint8_t is_inner_tx) {
+// Inner transaction of a multisig transaction or of a multisig signature
+static int parse_inner_transactions(parse_context_t *context, layout_state_t *state) {
+    uint8_t is_inner_tx = state->header->transactionType == NEM_TXN_MULTISIG;
     // Length of inner transaction object.
     // This can be a transfer, an importance transfer or an aggregate modification transaction
     uint32_t innerTxnLength;
-    BAIL_IF(_read_uint32(context, &innerTxnLength)); // Read uint32 and security check
-    BAIL_IF_ERR(!has_data(context, innerTxnLength), E_NOT_ENOUGH_DATA);
-    BAIL_IF(add_new_field(context, NEM_UINT64_MULTISIG_FEE, STI_NEM, sizeof(uint64_t), (const uint8_t *) &common_header->fee));
+    BAIL_IF(read_mark(context, state, M_VALUE, sizeof(uint32_t))); // Read uint32 and security check
+    innerTxnLength = mark_value(state, M_VALUE);
+    // A pulled message payload is counted in the length but not sent
+    BAIL_IF_ERR(!context->pullMessage && !has_data(context, innerTxnLength), E_NOT_ENOUGH_DATA);
+    BAIL_IF(add_new_field(context, NEM_UINT64_MULTISIG_FEE, STI_NEM, sizeof(uint64_t), state->marks[M_FEE].data));
     uint32_t innerOffset = 0;
     while (innerOffset < innerTxnLength) {
         uint32_t previousOffset = context->offset;
+        uint32_t previousPulledLength = pulled_length(context);
         // get header first
         common_txn_header_t *inner_header = (common_txn_header_t*) read_data(context, sizeof(common_txn_header_t)); // Read data and security check
         BAIL_IF_ERR(inner_header == NULL, E_NOT_ENOUGH_DATA);
         // Show inner transaction / detail transaction type
         BAIL_IF(add_new_field(context, is_inner_tx ? NEM_UINT32_INNER_TRANSACTION_TYPE : NEM_UINT32_DETAIL_TRANSACTION_TYPE, STI_UINT32, sizeof(uint32_t), (const uint8_t *) &inner_header->transactionType));
-        switch (inner_header->transactionType) {
-            case NEM_TXN_TRANSFER:
-                BAIL_IF(parse_transfer_transaction(context, inner_header));
-                break;
-            case NEM_TXN_IMPORTANCE_TRANSFER:
-                BAIL_IF(parse_importance_transfer_transaction(context, inner_header));
-                break;
-            case NEM_TXN_MULTISIG_AGGREGATE_MODIFICATION:
-                BAIL_IF(parse_aggregate_modification_transaction(context, inner_header));
-                break;
-            case NEM_TXN_MULTISIG_SIGNATURE:
-                if (context->transactionType != NEM_TXN_MULTISIG_SIGNATURE) {
-                    BAIL_IF(parse_multisig_signature_transaction(context, inner_header));
-                    break;
-                } else return E_INVALID_DATA;
-            case NEM_TXN_PROVISION_NAMESPACE:
-                BAIL_IF(parse_provision_namespace_transaction(context, inner_header));
-                break;
-            case NEM_TXN_MOSAIC_DEFINITION:
-                BAIL_IF(parse_mosaic_definition_creation_transaction(context, inner_header));
-                break;
-            case NEM_TXN_MOSAIC_SUPPLY_CHANGE:
-                BAIL_IF(parse_mosaic_supply_change_transaction(context, inner_header));
-                break;
-            default:
-                return E_INVALID_DATA;
-        }
-        innerOffset = innerOffset + context->offset - previousOffset;
+        // Multisig transactions cannot be nested, multisig signatures can only be in a multisig transaction
+        BAIL_IF_ERR(inner_header->transactionType == NEM_TXN_MULTISIG, E_INVALID_DATA);
+        BAIL_IF_ERR(inner_header->transactionType == NEM_TXN_MULTISIG_SIGNATURE &&
+                    context->transactionType == NEM_TXN_MULTISIG_SIGNATURE, E_INVALID_DATA);
+        BAIL_IF(parse_transaction(context, inner_header));
+        innerOffset = innerOffset + context->offset - previousOffset + pulled_length(context) - previousPulledLength;
     }
     return E_SUCCESS;
 }
 
 static int parse_txn_detail(parse_context_t *context, common_txn_header_t *common_header) {
-    int err;
     context->result.numFields = 0;
+    context->result.withinPolicy = 0;
+    context->result.mosaicMultiplier = NEM_TRANSFER_MULTIPLIER_ONE;
+    context->numMosaics = 0;
     // Show Transaction type
     BAIL_IF(add_new_field(context, NEM_UINT32_TRANSACTION_TYPE, STI_UINT32, sizeof(uint32_t), (const uint8_t *) &common_header->transactionType));
-    switch (common_header->transactionType) {
-        case NEM_TXN_TRANSFER:
-            err = parse_transfer_transaction(context, common_header);
-            break;
-        case NEM_TXN_IMPORTANCE_TRANSFER:
-            err = parse_importance_transfer_transaction(context, common_header);
-            break;
-        case NEM_TXN_MULTISIG_AGGREGATE_MODIFICATION:
-            err = parse_aggregate_modification_transaction(context, common_header);
-            break;
-        case NEM_TXN_MULTISIG_SIGNATURE:
-            err = parse_multisig_signature_transaction(context, common_header);
-            break;
-        case NEM_TXN_MULTISIG:
-            err = parse_multisig_transaction(context, common_header, 1);
-            break;
-        case NEM_TXN_PROVISION_NAMESPACE:
-            err = parse_provision_namespace_transaction(context, common_header);
-            break;
-        case NEM_TXN_MOSAIC_DEFINITION:
-            err = parse_mosaic_definition_creation_transaction(context, common_header);
-            break;
-        case NEM_TXN_MOSAIC_SUPPLY_CHANGE:
-            err = parse_mosaic_supply_change_transaction(context, common_header);
-            break;
-        default:
-            err = E_INVALID_DATA;
-            break;
-    }
-    return err;
+    return parse_transaction(context, common_header);
 }
 
 static void set_sign_data_length(parse_context_t *context) {
     if (context->transactionType == NEM_TXN_MULTISIG_SIGNATURE) {
         // Sign data from generation hash to transaction hash
-        transactionContext.rawTxLength = sizeof(multsig_signature_header_t) + sizeof(common_txn_header_t);
+        context->signDataLength = sizeof(multsig_signature_header_t) + sizeof(common_txn_header_t);
     } else {
         // Sign all data in the transaction
-        transactionContext.rawTxLength = context->length;
+        context->signDataLength = context->length;
     }
 }
 
@@ -576,12 +686,26 @@ static common_txn_header_t *parse_common_header(parse_context_t *context) {
     BAIL_IF_ERR(common_header == NULL, NULL);
     context->transactionType = common_header->transactionType;
     context->version = common_header->version;
+    context->timestamp = common_header->timestamp;
     return common_header;
 }
 
-int parse_txn_context(parse_context_t *context) {
+static int parse_txn(parse_context_t *context) {
     common_txn_header_t* txn = parse_common_header(context);
     BAIL_IF_ERR(txn == NULL, E_NOT_ENOUGH_DATA);
     set_sign_data_length(context);
-    return parse_txn_detail(context, txn);
+    context->result.networkType = context->networkType;
+    BAIL_IF(parse_txn_detail(context, txn));
+    context->result.withinPolicy = within_policy(context);
+    return E_SUCCESS;
+}
+
+int parse_txn_context(parse_context_t *context) {
+    PERF_START(PERF_PARSE);
+    int err = parse_txn(context);
+    PERF_STOP(PERF_PARSE);
+    if (err != E_SUCCESS) {
+        TRACE(TRACE_PARSE_ERROR, (uint32_t) err, context->offset);
+    }
+    return err;
 }
@@ -22,17 +22,38 @@
 #include "nem/nem_helpers.h"
 
 typedef struct result_t {
+    // Network of the signing account, public keys are displayed as addresses of this network
+    uint8_t networkType;
     uint8_t numFields;
     field_t fields[MAX_FIELD_COUNT];
+    // Amount of a version 2 transfer, the quantities of its mosaics are scaled by it when shown
+    uint64_t mosaicMultiplier;
+    // Set when the approval policy allows a one screen approval (see policy.h)
+    uint8_t withinPolicy;
 } result_t;
 
+// All the state of a parse: contexts can be used concurrently from several threads
 typedef struct parse_context_t {
     uint8_t version;
     uint32_t transactionType;
+    uint32_t timestamp;
+    // Mosaics attached to the transfers of the transaction
+    uint8_t numMosaics;
+    // Set by the caller
+    uint8_t networkType;
     uint8_t *data;
     result_t result;
     uint32_t length;
     uint32_t offset;
+    // Number of bytes to sign from the start of data, set by parse_txn_context()
+    uint32_t signDataLength;
+    // Set by the caller: the plain message payload of the transaction of a multisig signature
+    // is not in data, only its lengths are (see sign_transaction.c)
+    uint8_t pullMessage;
+    // Set by parse_txn_context() when such a payload was left out: index of the message field,
+    // whose data must be set by the caller, and offset of the payload in the transaction
+    uint8_t pulledField;
+    uint32_t pulledOffset;
 } parse_context_t;
 
 int parse_txn_context(parse_context_t *parseContext);
@@ -0,0 +1,107 @@
+/*******************************************************************************
+*   NEM Wallet
+*    (c) 2020 FDS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+#include "policy.h"
+#include "nem_helpers.h"
+#include "nem/format/fields.h"
+#include "nem/format/readers.h"
+#ifndef FUZZ
+#include "storage/storage.h"
+
+// Xem amount and fee of a transfer without mosaics to a recipient allowed by the policy,
+// false for any other transaction
+static bool read_transfer(const parse_context_t *context, uint8_t contactsOnly, uint64_t *amount, uint64_t *fee) {
+    bool hasRecipient = false;
+    bool hasAmount = false;
+    if (context->transactionType != NEM_TXN_TRANSFER || context->numMosaics != 0) {
+        return false;
+    }
+    *fee = 0;
+    for (uint8_t i = 0; i < context->result.numFields; i++) {
+        const field_t *field = &context->result.fields[i];
+        switch (field->id) {
+            case NEM_UINT32_TRANSACTION_TYPE:
+            case NEM_STR_TXN_MESSAGE:
+            case NEM_STR_ENC_MESSAGE:
+                break;
+            case NEM_STR_RECIPIENT_ADDRESS:
+                if (contactsOnly) {
+                    return false;
+                }
+                hasRecipient = true;
+                break;
+            case NEM_STR_RECIPIENT_CONTACT:
+                hasRecipient = true;
+                break;
+            case NEM_MOSAIC_AMOUNT:
+                *amount = read_uint64(field->data);
+                hasAmount = true;
+                break;
+            case NEM_UINT64_TXN_FEE:
+                *fee = read_uint64(field->data);
+                break;
+            default:
+                return false;
+        }
+    }
+    return hasRecipient && hasAmount;
+}
+
+// Transactions after the end of the current period start a new one. Earlier timestamps
+// count in the current period, the network rejects timestamps far from its time.
+static bool is_new_period(uint32_t timestamp) {
+    uint32_t start = N_storage.policyState.periodStart;
+    return timestamp >= start && timestamp - start >= N_storage.policy.periodLength;
+}
+
+bool within_policy(const parse_context_t *context) {
+    uint64_t amount;
+    uint64_t fee;
+    if (!N_storage.policy.enabled || !read_transfer(context, N_storage.policy.contactsOnly, &amount, &fee) ||
+        amount > N_storage.policy.maxAmount || fee > N_storage.policy.maxFee) {
+        return false;
+    }
+    uint64_t spent = is_new_period(context->timestamp) ? 0 : N_storage.policyState.periodSpent;
+    return spent + amount + fee <= N_storage.policy.periodCap;
+}
+
+void record_policy_approval(const parse_context_t *context) {
+    policy_state_t state;
+    uint64_t amount;
+    uint64_t fee;
+    if (!read_transfer(context, 0, &amount, &fee)) {
+        return;
+    }
+    if (is_new_period(context->timestamp)) {
+        state.periodStart = context->timestamp;
+        state.periodSpent = 0;
+    } else {
+        state.periodStart = N_storage.policyState.periodStart;
+        state.periodSpent = N_storage.policyState.periodSpent;
+    }
+    state.periodSpent += amount + fee;
+    write_policy_state(&state);
+}
+#else
+bool within_policy(const parse_context_t *context) {
+    (void) context;
+    return false;
+}
+
+void record_policy_approval(const parse_context_t *context) {
+    (void) context;
+}
+#endif
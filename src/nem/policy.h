@@ -0,0 +1,53 @@
+/*******************************************************************************
+*   NEM Wallet
+*    (c) 2020 FDS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+#ifndef LEDGER_APP_NEM_POLICY_H
+#define LEDGER_APP_NEM_POLICY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "nem/parse/nem_parse.h"
+
+// Caps are below the total supply of xem (micro nem), sums of amounts cannot overflow
+#define MAX_POLICY_AMOUNT 9000000000000000ull
+#define MAX_POLICY_PERIOD_HOURS 744
+
+// Limits within which plain xem transfers are approved on a single screen
+typedef struct policy_t {
+    uint8_t enabled;
+    // Recipients must be in the address book
+    uint8_t contactsOnly;
+    // Caps of the amount and of the fee of each transaction (micro nem)
+    uint64_t maxAmount;
+    uint64_t maxFee;
+    // Cap of the amounts and fees approved within a period, 0 seconds if no policy was set
+    uint64_t periodCap;
+    uint32_t periodLength;
+} policy_t;
+
+typedef struct policy_state_t {
+    // Timestamp of the first transaction of the current period, and spending since then
+    uint32_t periodStart;
+    uint64_t periodSpent;
+} policy_state_t;
+
+// True if the enabled policy allows the parsed transaction to be approved on a single screen.
+// Always false in host parser builds, which have no NVRAM.
+bool within_policy(const parse_context_t *context);
+// Count the amount and fee of a transaction within policy in the spending of its period
+void record_policy_approval(const parse_context_t *context);
+
+#endif //LEDGER_APP_NEM_POLICY_H
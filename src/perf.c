@@ -0,0 +1,74 @@
+/*******************************************************************************
+*   NEM Wallet
+*    (c) 2020 FDS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+#include "perf.h"
+
+#ifdef HAVE_PERF_COUNTERS
+#include <string.h>
+
+#ifndef PERF_TICKS_PER_SECOND
+#error "PERF_TICKS_PER_SECOND must be defined with PERF_TICK_FUNCTION"
+#endif
+
+#ifdef PERF_TICKER_PERIOD
+volatile uint32_t perfTicks;
+#endif
+
+static perf_counter_t counters[PERF_MAX_COUNTERS];
+static uint8_t numCounters;
+static uint8_t currentInstruction;
+
+void perf_set_instruction(uint8_t instruction) {
+    currentInstruction = instruction;
+}
+
+void perf_record(perf_phase_t phase, uint32_t ticks) {
+    perf_counter_t *counter = NULL;
+    for (uint8_t i = 0; i < numCounters; i++) {
+        if (counters[i].instruction == currentInstruction && counters[i].phase == phase) {
+            counter = &counters[i];
+            break;
+        }
+    }
+    if (counter == NULL) {
+        if (numCounters == PERF_MAX_COUNTERS) {
+            return;
+        }
+        counter = &counters[numCounters++];
+        counter->instruction = currentInstruction;
+        counter->phase = phase;
+        counter->min = ticks;
+    }
+    counter->count++;
+    counter->total += ticks;
+    if (ticks < counter->min) {
+        counter->min = ticks;
+    }
+    if (ticks > counter->max) {
+        counter->max = ticks;
+    }
+}
+
+const perf_counter_t *get_perf_counters(uint8_t *count) {
+    *count = numCounters;
+    return counters;
+}
+
+void reset_perf_counters() {
+    memset(counters, 0, sizeof(counters));
+    numCounters = 0;
+}
+#endif
@@ -0,0 +1,78 @@
+/*******************************************************************************
+*   NEM Wallet
+*    (c) 2020 FDS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+#ifndef LEDGER_APP_NEM_PERF_H
+#define LEDGER_APP_NEM_PERF_H
+
+#include <stdint.h>
+
+// Phases timed with HAVE_PERF_COUNTERS (make PERF_COUNTERS=1), per instruction
+typedef enum perf_phase_t {
+    // handle_apdu()
+    PERF_APDU,
+    // handle_packet_content(): a chunk of the transaction, parsing and review included for the last one
+    PERF_PACKET,
+    PERF_PARSE,
+    // update_content(): formatting of a step of the review
+    PERF_FORMAT,
+    PERF_DERIVE,
+    PERF_SIGN,
+} perf_phase_t;
+
+#ifdef HAVE_PERF_COUNTERS
+
+#ifdef PERF_TICK_FUNCTION
+// Clock of the build, e.g. the simulator, which also sets PERF_TICKS_PER_SECOND
+uint32_t PERF_TICK_FUNCTION(void);
+#define PERF_TICKS() PERF_TICK_FUNCTION()
+#else
+// Apps cannot read a cycle counter: ticks are counted by the ticker events of main.c,
+// which are only processed between APDUs and in io_seproxyhal_io_heartbeat()
+extern volatile uint32_t perfTicks;
+#define PERF_TICKS() perfTicks
+#define PERF_TICKS_PER_SECOND 1000
+#define PERF_TICKER_PERIOD 100
+#endif
+
+#define PERF_MAX_COUNTERS 12
+
+typedef struct perf_counter_t {
+    uint8_t instruction;
+    uint8_t phase;
+    uint32_t count;
+    uint64_t total;
+    uint32_t min;
+    uint32_t max;
+} perf_counter_t;
+
+#define PERF_START(phase) uint32_t perfStart_##phase = PERF_TICKS()
+#define PERF_STOP(phase) perf_record(phase, PERF_TICKS() - perfStart_##phase)
+
+// Following samples are counted for this instruction
+void perf_set_instruction(uint8_t instruction);
+// Samples of new (instruction, phase) pairs are dropped once PERF_MAX_COUNTERS are used
+void perf_record(perf_phase_t phase, uint32_t ticks);
+const perf_counter_t *get_perf_counters(uint8_t *count);
+void reset_perf_counters();
+
+#else
+
+#define PERF_START(phase)
+#define PERF_STOP(phase)
+
+#endif
+
+#endif //LEDGER_APP_NEM_PERF_H
@@ -0,0 +1,48 @@
+/*******************************************************************************
+*   NEM Wallet
+*    (c) 2020 FDS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+#include "stack_usage.h"
+
+#ifdef HAVE_STACK_PAINTING
+#define STACK_PAINT 0xA5A5A5A5u
+// Words left unpainted below the frame of paint_stack()
+#define STACK_PAINT_MARGIN 16
+
+// Bounds of the application stack, from the linker script of the SDK
+extern uint32_t _stack;
+extern uint32_t _estack;
+
+// The first word is skipped, the SDK may keep its stack canary there
+void paint_stack() {
+    volatile uint32_t marker;
+    uint32_t *end = (uint32_t *) &marker - STACK_PAINT_MARGIN;
+    for (uint32_t *word = &_stack + 1; word < end; word++) {
+        *word = STACK_PAINT;
+    }
+}
+
+uint32_t get_stack_size() {
+    return (uint32_t) ((uintptr_t) &_estack - (uintptr_t) &_stack);
+}
+
+uint32_t get_stack_high_water_mark() {
+    const uint32_t *word = &_stack + 1;
+    while (word < &_estack && *word == STACK_PAINT) {
+        word++;
+    }
+    return (uint32_t) ((uintptr_t) &_estack - (uintptr_t) word);
+}
+#endif
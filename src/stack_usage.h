@@ -0,0 +1,34 @@
+/*******************************************************************************
+*   NEM Wallet
+*    (c) 2020 FDS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+#ifndef LEDGER_APP_NEM_STACKUSAGE_H
+#define LEDGER_APP_NEM_STACKUSAGE_H
+
+#include <stdint.h>
+
+// With HAVE_STACK_PAINTING (make STACK_PAINTING=1), the free stack is filled with a
+// pattern at boot and the deepest use since then is found by scanning for the pattern
+#ifdef HAVE_STACK_PAINTING
+
+// Called first in main(), before any deep call
+void paint_stack();
+uint32_t get_stack_size();
+// Bytes used at the deepest point since boot
+uint32_t get_stack_high_water_mark();
+
+#endif
+
+#endif //LEDGER_APP_NEM_STACKUSAGE_H
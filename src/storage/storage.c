@@ -0,0 +1,269 @@
+/*******************************************************************************
+*    NEM Wallet
+*    (c) 2020 Ledger
+*    (c) 2020 FDS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+#include "storage.h"
+#include "nem/contacts.h"
+
+// Placed in NVRAM by the linker because of its N_ prefix
+const internal_storage_t N_storage_real;
+
+void init_storage() {
+    if (N_storage.initialized != STORAGE_VERSION) {
+        settings_t settings;
+        uint8_t version = STORAGE_VERSION;
+        // Cleared in place, the storage is larger than the stack
+        nvm_write((void *) &N_storage, NULL, sizeof(internal_storage_t));
+        memset(&settings, 0, sizeof(settings_t));
+        settings.chunkSize = CHUNK_SIZE_LARGE;
+        write_settings(&settings);
+        nvm_write((void *) &N_storage.initialized, &version, sizeof(uint8_t));
+    }
+}
+
+void write_settings(const settings_t *settings) {
+    nvm_write((void *) &N_storage.settings, (void *) settings, sizeof(settings_t));
+}
+
+static uint8_t seedFingerprint[SEED_FINGERPRINT_LENGTH];
+static bool hasSeedFingerprint;
+
+// Hash of the private key of an account no wallet uses, computed once per run of the application
+static const uint8_t *get_seed_fingerprint() {
+    uint32_t path[] = {0x8000002C, 0x8000002B, 0xFFFFFFFF};
+    uint8_t privateKey[NEM_PRIVATE_KEY_LENGTH];
+    uint8_t hash[32];
+    cx_sha3_t sha3;
+
+    if (hasSeedFingerprint) {
+        return seedFingerprint;
+    }
+    BEGIN_TRY {
+        TRY {
+            os_perso_derive_node_bip32_seed_key(HDW_ED25519_SLIP10, CX_CURVE_Ed25519, path, 3, privateKey, NULL,
+                                                (unsigned char *) "ed25519-keccak seed", 19);
+            cx_keccak_init(&sha3, 256);
+            cx_hash(&sha3.header, CX_LAST, privateKey, NEM_PRIVATE_KEY_LENGTH, hash, sizeof(hash));
+            memcpy(seedFingerprint, hash, SEED_FINGERPRINT_LENGTH);
+            hasSeedFingerprint = true;
+        }
+        FINALLY {
+            explicit_bzero(privateKey, sizeof(privateKey));
+        }
+    }
+    END_TRY;
+    return seedFingerprint;
+}
+
+static bool is_same_account(const volatile public_key_cache_entry_t *entry, const uint32_t *bip32Path,
+                            uint8_t pathLength, uint8_t networkType) {
+    if (!entry->valid || entry->networkType != networkType || entry->pathLength != pathLength ||
+        memcmp((const void *) entry->seedFingerprint, get_seed_fingerprint(), SEED_FINGERPRINT_LENGTH) != 0) {
+        return false;
+    }
+    for (uint8_t i = 0; i < pathLength; i++) {
+        if (entry->bip32Path[i] != bip32Path[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Public keys are not secret, caching them avoids a derivation and the address hashing
+bool get_cached_public_key(const uint32_t *bip32Path, uint8_t pathLength, uint8_t networkType,
+                           uint8_t *publicKey, uint8_t *rawAddress) {
+    for (uint8_t i = 0; i < PUBLIC_KEY_CACHE_SIZE; i++) {
+        const volatile public_key_cache_entry_t *entry = &N_storage.publicKeyCache[i];
+        if (is_same_account(entry, bip32Path, pathLength, networkType)) {
+            memcpy(publicKey, (const void *) entry->publicKey, NEM_PUBLIC_KEY_LENGTH);
+            memcpy(rawAddress, (const void *) entry->rawAddress, NEM_RAW_ADDRESS_LENGTH);
+            return true;
+        }
+    }
+    return false;
+}
+
+void cache_public_key(const uint32_t *bip32Path, uint8_t pathLength, uint8_t networkType,
+                      const uint8_t *publicKey, const uint8_t *rawAddress) {
+    public_key_cache_entry_t entry;
+    uint8_t next = N_storage.publicKeyCacheNext;
+    if (next >= PUBLIC_KEY_CACHE_SIZE) {
+        next = 0;
+    }
+    memset(&entry, 0, sizeof(public_key_cache_entry_t));
+    entry.valid = 1;
+    entry.networkType = networkType;
+    entry.pathLength = pathLength;
+    memcpy(entry.bip32Path, bip32Path, pathLength * sizeof(uint32_t));
+    memcpy(entry.publicKey, publicKey, NEM_PUBLIC_KEY_LENGTH);
+    memcpy(entry.rawAddress, rawAddress, NEM_RAW_ADDRESS_LENGTH);
+    memcpy(entry.seedFingerprint, get_seed_fingerprint(), SEED_FINGERPRINT_LENGTH);
+    nvm_write((void *) &N_storage.publicKeyCache[next], &entry, sizeof(public_key_cache_entry_t));
+    next = (next + 1) % PUBLIC_KEY_CACHE_SIZE;
+    nvm_write((void *) &N_storage.publicKeyCacheNext, &next, sizeof(uint8_t));
+}
+
+void clear_public_key_cache() {
+    public_key_cache_entry_t entry;
+    memset(&entry, 0, sizeof(public_key_cache_entry_t));
+    for (uint8_t i = 0; i < PUBLIC_KEY_CACHE_SIZE; i++) {
+        if (N_storage.publicKeyCache[i].valid) {
+            nvm_write((void *) &N_storage.publicKeyCache[i], &entry, sizeof(public_key_cache_entry_t));
+        }
+    }
+}
+
+static bool is_same_mosaic(const volatile mosaic_cache_entry_t *entry, uint32_t hash,
+                           const uint8_t *namespaceId, uint32_t namespaceLength,
+                           const uint8_t *name, uint32_t nameLength, uint8_t networkType) {
+    const volatile mosaic_metadata_t *metadata = &entry->metadata;
+    return entry->hash == hash && metadata->networkType == networkType &&
+           metadata->id.namespaceLength == namespaceLength && metadata->id.nameLength == nameLength &&
+           memcmp((const void *) metadata->id.namespaceId, namespaceId, namespaceLength) == 0 &&
+           memcmp((const void *) metadata->id.name, name, nameLength) == 0;
+}
+
+// Open addressing: an entry is in the first free slot after the one of its hash,
+// lookups stop at the first free slot (entries are replaced, never removed)
+static uint8_t find_mosaic_slot(uint32_t hash, const uint8_t *namespaceId, uint32_t namespaceLength,
+                                const uint8_t *name, uint32_t nameLength, uint8_t networkType) {
+    for (uint8_t i = 0; i < MOSAIC_CACHE_SIZE; i++) {
+        uint8_t slot = (hash + i) % MOSAIC_CACHE_SIZE;
+        const volatile mosaic_cache_entry_t *entry = &N_storage.mosaicCache[slot];
+        if (!entry->valid ||
+            is_same_mosaic(entry, hash, namespaceId, namespaceLength, name, nameLength, networkType)) {
+            return slot;
+        }
+    }
+    return MOSAIC_CACHE_SIZE;
+}
+
+// The entry is read in place, it stays valid until the next cache_mosaic()
+const mosaic_metadata_t *get_cached_mosaic(const uint8_t *namespaceId, uint32_t namespaceLength,
+                                           const uint8_t *name, uint32_t nameLength, uint8_t networkType) {
+    uint32_t hash = mosaic_hash(namespaceId, namespaceLength, name, nameLength);
+    uint8_t slot = find_mosaic_slot(hash, namespaceId, namespaceLength, name, nameLength, networkType);
+    if (slot == MOSAIC_CACHE_SIZE || !N_storage.mosaicCache[slot].valid) {
+        return NULL;
+    }
+    return (const mosaic_metadata_t *) &N_storage.mosaicCache[slot].metadata;
+}
+
+bool cache_mosaic(const mosaic_metadata_t *metadata) {
+    mosaic_cache_entry_t entry;
+    const uint8_t *namespaceId = (const uint8_t *) metadata->id.namespaceId;
+    const uint8_t *name = (const uint8_t *) metadata->id.name;
+    uint32_t hash = mosaic_hash(namespaceId, metadata->id.namespaceLength, name, metadata->id.nameLength);
+    uint8_t slot = find_mosaic_slot(hash, namespaceId, metadata->id.namespaceLength,
+                                    name, metadata->id.nameLength, metadata->networkType);
+    if (slot != MOSAIC_CACHE_SIZE && N_storage.mosaicCache[slot].valid) {
+        if (metadata->revision < N_storage.mosaicCache[slot].metadata.revision) {
+            return false;
+        }
+    } else if (metadata->revision < N_storage.mosaicRevisionFloor) {
+        return false;
+    }
+    if (slot == MOSAIC_CACHE_SIZE) {
+        // Full, replace the entry in the slot of the hash
+        slot = hash % MOSAIC_CACHE_SIZE;
+        uint32_t revision = N_storage.mosaicCache[slot].metadata.revision;
+        if (revision > N_storage.mosaicRevisionFloor) {
+            nvm_write((void *) &N_storage.mosaicRevisionFloor, &revision, sizeof(revision));
+        }
+    }
+    memset(&entry, 0, sizeof(mosaic_cache_entry_t));
+    entry.valid = 1;
+    entry.hash = hash;
+    memcpy(&entry.metadata, metadata, sizeof(mosaic_metadata_t));
+    nvm_write((void *) &N_storage.mosaicCache[slot], &entry, sizeof(mosaic_cache_entry_t));
+    return true;
+}
+
+// Never 0, which marks free slots
+static uint16_t contact_tag(uint32_t hash) {
+    return (uint16_t) (hash >> 16u) | 1u;
+}
+
+// Slot of the address, or the free slot it would be added to (ADDRESS_BOOK_SIZE if
+// the book is full). Open addressing like the mosaic cache, but probing the index.
+static uint16_t find_contact_slot(const uint8_t *address) {
+    uint32_t hash = contact_hash(address);
+    uint16_t tag = contact_tag(hash);
+    for (uint16_t i = 0; i < ADDRESS_BOOK_SIZE; i++) {
+        uint16_t slot = (hash + i) % ADDRESS_BOOK_SIZE;
+        uint16_t slotTag = N_storage.addressBookIndex[slot];
+        if (slotTag == 0 ||
+            (slotTag == tag &&
+             memcmp((const void *) N_storage.addressBook[slot].address, address, NEM_ADDRESS_LENGTH) == 0)) {
+            return slot;
+        }
+    }
+    return ADDRESS_BOOK_SIZE;
+}
+
+// The label is read in place, it stays valid until the address book is changed
+const char *get_contact_label(const uint8_t *address) {
+    uint16_t slot = find_contact_slot(address);
+    if (slot == ADDRESS_BOOK_SIZE || N_storage.addressBookIndex[slot] == 0) {
+        return NULL;
+    }
+    return (const char *) N_storage.addressBook[slot].label;
+}
+
+bool can_add_contact(const uint8_t *address) {
+    return find_contact_slot(address) != ADDRESS_BOOK_SIZE;
+}
+
+bool add_contact(const uint8_t *address, const char *label) {
+    address_book_entry_t entry;
+    uint16_t slot = find_contact_slot(address);
+    if (slot == ADDRESS_BOOK_SIZE) {
+        return false;
+    }
+    memset(&entry, 0, sizeof(address_book_entry_t));
+    memcpy(entry.address, address, NEM_ADDRESS_LENGTH);
+    strncpy(entry.label, label, MAX_CONTACT_LABEL_LEN);
+    nvm_write((void *) &N_storage.addressBook[slot], &entry, sizeof(address_book_entry_t));
+    // The entry is only reachable once its tag is written
+    uint16_t tag = contact_tag(contact_hash(address));
+    nvm_write((void *) &N_storage.addressBookIndex[slot], &tag, sizeof(uint16_t));
+    return true;
+}
+
+uint16_t count_contacts() {
+    uint16_t count = 0;
+    for (uint16_t i = 0; i < ADDRESS_BOOK_SIZE; i++) {
+        count += N_storage.addressBookIndex[i] != 0;
+    }
+    return count;
+}
+
+void clear_address_book() {
+    for (uint16_t i = 0; i < ADDRESS_BOOK_SIZE; i++) {
+        if (N_storage.addressBookIndex[i] != 0) {
+            nvm_write((void *) &N_storage.addressBookIndex[i], NULL, sizeof(uint16_t));
+            nvm_write((void *) &N_storage.addressBook[i], NULL, sizeof(address_book_entry_t));
+        }
+    }
+}
+
+void write_policy(const policy_t *policy) {
+    nvm_write((void *) &N_storage.policy, (void *) policy, sizeof(policy_t));
+}
+
+void write_policy_state(const policy_state_t *state) {
+    nvm_write((void *) &N_storage.policyState, (void *) state, sizeof(policy_state_t));
+}
@@ -0,0 +1,121 @@
+/*******************************************************************************
+*    NEM Wallet
+*    (c) 2020 Ledger
+*    (c) 2020 FDS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+#ifndef LEDGER_APP_NEM_STORAGE_H
+#define LEDGER_APP_NEM_STORAGE_H
+
+#include <os.h>
+#include <stdint.h>
+#include "limitations.h"
+#include "nem/nem_helpers.h"
+#include "nem/mosaics.h"
+#include "nem/policy.h"
+
+// Bump when the layout of internal_storage_t changes, the storage is then reset
+#define STORAGE_VERSION 0x08
+
+#define PUBLIC_KEY_CACHE_SIZE 8
+#define SEED_FINGERPRINT_LENGTH 8
+#define MOSAIC_CACHE_SIZE 8
+
+#define CHUNK_SIZE_LARGE 255
+#define CHUNK_SIZE_MEDIUM 128
+#define CHUNK_SIZE_SMALL 64
+
+typedef struct settings_t {
+    // Start the review with a summary of the transaction
+    uint8_t summaryReview;
+    // Derive the signing key when the approval step of the review is displayed
+    uint8_t preDeriveKey;
+    // Preferred size of the transaction chunks sent by the host
+    uint8_t chunkSize;
+    // Remember the public keys of the last used accounts
+    uint8_t publicKeyCache;
+} settings_t;
+
+typedef struct public_key_cache_entry_t {
+    uint8_t valid;
+    uint8_t networkType;
+    uint8_t pathLength;
+    uint32_t bip32Path[MAX_BIP32_PATH];
+    uint8_t publicKey[NEM_PUBLIC_KEY_LENGTH];
+    uint8_t rawAddress[NEM_RAW_ADDRESS_LENGTH];
+    // Entries of another seed (e.g. unlocked with a passphrase PIN) are ignored
+    uint8_t seedFingerprint[SEED_FINGERPRINT_LENGTH];
+} public_key_cache_entry_t;
+
+typedef struct mosaic_cache_entry_t {
+    uint8_t valid;
+    // mosaic_hash() of the id, also the first slot probed for it
+    uint32_t hash;
+    mosaic_metadata_t metadata;
+} mosaic_cache_entry_t;
+
+typedef struct address_book_entry_t {
+    char address[NEM_ADDRESS_LENGTH];
+    // NUL terminated
+    char label[MAX_CONTACT_LABEL_LEN + 1];
+} address_book_entry_t;
+
+typedef struct internal_storage_t {
+    uint8_t initialized;
+    settings_t settings;
+    // Entry to be replaced by the next cache miss
+    uint8_t publicKeyCacheNext;
+    public_key_cache_entry_t publicKeyCache[PUBLIC_KEY_CACHE_SIZE];
+    mosaic_cache_entry_t mosaicCache[MOSAIC_CACHE_SIZE];
+    // Highest revision of the entries replaced in the full cache: mosaics that are not cached
+    // need at least this revision, so replacing an entry cannot bring an older one back
+    uint32_t mosaicRevisionFloor;
+    // Tag of the entry in each slot of the address book, 0 for free slots. Lookups
+    // scan the tags and only compare the addresses of the entries with the same tag.
+    uint16_t addressBookIndex[ADDRESS_BOOK_SIZE];
+    address_book_entry_t addressBook[ADDRESS_BOOK_SIZE];
+    policy_t policy;
+    policy_state_t policyState;
+} internal_storage_t;
+
+extern const internal_storage_t N_storage_real;
+#define N_storage (*(volatile internal_storage_t *) PIC(&N_storage_real))
+
+void init_storage();
+void write_settings(const settings_t *settings);
+
+bool get_cached_public_key(const uint32_t *bip32Path, uint8_t pathLength, uint8_t networkType,
+                           uint8_t *publicKey, uint8_t *rawAddress);
+void cache_public_key(const uint32_t *bip32Path, uint8_t pathLength, uint8_t networkType,
+                      const uint8_t *publicKey, const uint8_t *rawAddress);
+void clear_public_key_cache();
+
+const mosaic_metadata_t *get_cached_mosaic(const uint8_t *namespaceId, uint32_t namespaceLength,
+                                           const uint8_t *name, uint32_t nameLength, uint8_t networkType);
+// Returns false, leaving the cache unchanged, if the metadata is older than the cached one
+bool cache_mosaic(const mosaic_metadata_t *metadata);
+
+// Addresses are NEM_ADDRESS_LENGTH base32 characters
+const char *get_contact_label(const uint8_t *address);
+// False if the address is new and the address book is full
+bool can_add_contact(const uint8_t *address);
+// Adds the address or replaces its label, returns false if the address book is full
+bool add_contact(const uint8_t *address, const char *label);
+uint16_t count_contacts();
+void clear_address_book();
+
+void write_policy(const policy_t *policy);
+void write_policy_state(const policy_state_t *state);
+
+#endif //LEDGER_APP_NEM_STORAGE_H
@@ -0,0 +1,47 @@
+/*******************************************************************************
+*   NEM Wallet
+*    (c) 2020 FDS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+#include "trace.h"
+
+#ifdef HAVE_TRACE
+#if (TRACE_SIZE & (TRACE_SIZE - 1)) != 0
+#error "TRACE_SIZE must be a power of two"
+#endif
+
+static trace_event_t ring[TRACE_SIZE];
+// Sequence numbers of the next event written and of the next event read
+static uint32_t writeSequence;
+static uint32_t readSequence;
+
+void trace_event(trace_event_id_t id, uint32_t arg0, uint32_t arg1) {
+    trace_event_t *event = &ring[writeSequence++ & (TRACE_SIZE - 1)];
+    event->id = id;
+    event->arg0 = arg0;
+    event->arg1 = arg1;
+}
+
+bool next_trace_event(trace_event_t *event, uint32_t *sequence) {
+    if (writeSequence - readSequence > TRACE_SIZE) {
+        readSequence = writeSequence - TRACE_SIZE;
+    }
+    if (readSequence == writeSequence) {
+        return false;
+    }
+    *sequence = readSequence;
+    *event = ring[readSequence++ & (TRACE_SIZE - 1)];
+    return true;
+}
+#endif
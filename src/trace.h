@@ -0,0 +1,67 @@
+/*******************************************************************************
+*   NEM Wallet
+*    (c) 2020 FDS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+#ifndef LEDGER_APP_NEM_TRACE_H
+#define LEDGER_APP_NEM_TRACE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Events recorded with HAVE_TRACE (make TRACE=1), with their two arguments
+typedef enum trace_event_id_t {
+    // Instruction | P1 << 8 | P2 << 16, data length
+    TRACE_APDU = 1,
+    // Last instruction, status word (0 when the handler returned without an exception, e.g. asynchronous replies)
+    TRACE_STATUS,
+    // read_data(): offset, length
+    TRACE_READ,
+    // Parsing error: error, offset
+    TRACE_PARSE_ERROR,
+    // update_content(): field id, step index
+    TRACE_FIELD,
+} trace_event_id_t;
+
+#ifdef HAVE_TRACE
+
+#include "limitations.h"
+
+// Power of two, the oldest events are overwritten
+#if defined(TARGET_NANOX) || defined(TARGET_NANOS2)
+#define TRACE_SIZE 64
+#else
+#define TRACE_SIZE 16
+#endif
+
+typedef struct trace_event_t {
+    uint8_t id;
+    uint32_t arg0;
+    uint32_t arg1;
+} trace_event_t;
+
+#define TRACE(id, arg0, arg1) trace_event(id, arg0, arg1)
+
+void trace_event(trace_event_id_t id, uint32_t arg0, uint32_t arg1);
+// Oldest event not read yet and its number in the whole trace, false if there is none.
+// Events overwritten before being read are skipped.
+bool next_trace_event(trace_event_t *event, uint32_t *sequence);
+
+#else
+
+#define TRACE(id, arg0, arg1)
+
+#endif
+
+#endif //LEDGER_APP_NEM_TRACE_H
@@ -28,6 +28,8 @@ extern char fieldValue[MAX_FIELD_LEN];
 action_t approval_action;
 action_t rejection_action;
 
+char contactLabel[MAX_CONTACT_LABEL_LEN + 1];
+
 UX_STEP_NOCB(
         ux_display_address_flow_1_step,
         pnn,
@@ -78,3 +80,38 @@ void display_address_confirmation_ui(char* address, action_t onApprove, action_t
     strncpy(fieldValue, address, NEM_PRETTY_ADDRESS_LENGTH);
     ux_flow_init(0, ux_display_address_flow, NULL);
 }
+
+UX_STEP_NOCB(
+        ux_display_contact_flow_1_step,
+        pnn,
+        {
+            &C_icon_eye,
+            "Add to",
+            "address book",
+        });
+
+UX_STEP_NOCB(
+        ux_display_contact_flow_2_step,
+        bnnn_paging,
+        {
+            "Label",
+            contactLabel,
+        });
+
+UX_FLOW(ux_display_contact_flow,
+       &ux_display_contact_flow_1_step,
+       &ux_display_contact_flow_2_step,
+       &ux_display_address_flow_2_step,
+       &ux_display_address_flow_3_step,
+       &ux_display_address_flow_4_step
+);
+
+void display_contact_confirmation_ui(const char *label, const char *address, action_t onApprove, action_t onReject) {
+    approval_action = onApprove;
+    rejection_action = onReject;
+
+    strncpy(contactLabel, label, sizeof(contactLabel));
+    explicit_bzero(fieldValue, MAX_FIELD_LEN);
+    memcpy(fieldValue, address, NEM_ADDRESS_LENGTH);
+    ux_flow_init(0, ux_display_contact_flow, NULL);
+}
@@ -21,5 +21,7 @@
 #include "common.h"
 
 void display_address_confirmation_ui(char* address, action_t onApprove, action_t onReject);
+// Address of NEM_ADDRESS_LENGTH characters, label NUL terminated
+void display_contact_confirmation_ui(const char *label, const char *address, action_t onApprove, action_t onReject);
 
 #endif //LEDGER_APP_NEM_ADDRESSUI_H
@@ -18,6 +18,7 @@
 #include "idle_menu.h"
 #include <os_io_seproxyhal.h>
 #include <ux.h>
+#include "ui/settings/settings_menu.h"
 #include "glyphs.h"
 
 UX_STEP_NOCB(
@@ -40,6 +41,15 @@ UX_STEP_NOCB(
 UX_STEP_VALID(
         ux_idle_flow_3_step,
         pb,
+        display_settings_menu(),
+        {
+            &C_icon_toggle_set,
+            "Settings",
+        });
+
+UX_STEP_VALID(
+        ux_idle_flow_4_step,
+        pb,
         os_sched_exit(-1),
         {
             &C_icon_dashboard_x,
@@ -50,6 +60,7 @@ const ux_flow_step_t * const ux_idle_flow [] = {
         &ux_idle_flow_1_step,
         &ux_idle_flow_2_step,
         &ux_idle_flow_3_step,
+        &ux_idle_flow_4_step,
         FLOW_END_STEP,
 };
 
@@ -0,0 +1,345 @@
+/*******************************************************************************
+*    NEM Wallet
+*    (c) 2020 Ledger
+*    (c) 2020 FDS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+#include "settings_menu.h"
+#include <os_io_seproxyhal.h>
+#include <ux.h>
+#include <stdio.h>
+#include "storage/storage.h"
+#include "nem/format/printers.h"
+#include "ui/main/idle_menu.h"
+#include "glyphs.h"
+
+#define LABEL_ENABLED "Enabled"
+#define LABEL_DISABLED "Disabled"
+#define LABEL_NOT_SET "Not set"
+
+char summaryReviewLabel[sizeof(LABEL_DISABLED)];
+char preDeriveKeyLabel[sizeof(LABEL_DISABLED)];
+char chunkSizeLabel[sizeof("255 bytes")];
+char publicKeyCacheLabel[sizeof(LABEL_DISABLED)];
+char addressBookLabel[sizeof("65535 contacts")];
+char policyLabel[sizeof(LABEL_DISABLED)];
+
+extern char fieldValue[MAX_FIELD_LEN];
+
+const policy_t *reviewedPolicy;
+action_t policyApprovalAction;
+action_t policyRejectionAction;
+
+static void toggle_summary_review();
+static void toggle_pre_derive_key();
+static void switch_chunk_size();
+static void toggle_public_key_cache();
+static void display_clear_address_book();
+static void clear_contacts();
+static void toggle_policy();
+static void update_policy_value(int stackSlot);
+
+UX_STEP_VALID(
+        ux_settings_flow_1_step,
+        bn,
+        toggle_summary_review(),
+        {
+            "Summary review",
+            summaryReviewLabel,
+        });
+
+UX_STEP_VALID(
+        ux_settings_flow_2_step,
+        bn,
+        toggle_pre_derive_key(),
+        {
+            "Pre-derive key",
+            preDeriveKeyLabel,
+        });
+
+UX_STEP_VALID(
+        ux_settings_flow_3_step,
+        bn,
+        switch_chunk_size(),
+        {
+            "Chunk size",
+            chunkSizeLabel,
+        });
+
+UX_STEP_VALID(
+        ux_settings_flow_4_step,
+        bn,
+        toggle_public_key_cache(),
+        {
+            "Pubkey cache",
+            publicKeyCacheLabel,
+        });
+
+UX_STEP_VALID(
+        ux_settings_flow_5_step,
+        bn,
+        display_clear_address_book(),
+        {
+            "Address book",
+            addressBookLabel,
+        });
+
+UX_STEP_VALID(
+        ux_settings_flow_6_step,
+        bn,
+        toggle_policy(),
+        {
+            "Approval policy",
+            policyLabel,
+        });
+
+UX_STEP_VALID(
+        ux_settings_flow_7_step,
+        pb,
+        display_idle_menu(),
+        {
+            &C_icon_back_x,
+            "Back",
+        });
+
+UX_FLOW(ux_settings_flow,
+        &ux_settings_flow_1_step,
+        &ux_settings_flow_2_step,
+        &ux_settings_flow_3_step,
+        &ux_settings_flow_4_step,
+        &ux_settings_flow_5_step,
+        &ux_settings_flow_6_step,
+        &ux_settings_flow_7_step
+);
+
+UX_STEP_NOCB(
+        ux_clear_address_book_flow_1_step,
+        pnn,
+        {
+            &C_icon_warning,
+            "Clear the",
+            "address book?",
+        });
+
+UX_STEP_VALID(
+        ux_clear_address_book_flow_2_step,
+        pb,
+        clear_contacts(),
+        {
+            &C_icon_validate_14,
+            "Clear",
+        });
+
+UX_STEP_VALID(
+        ux_clear_address_book_flow_3_step,
+        pb,
+        ux_flow_init(0, ux_settings_flow, &ux_settings_flow_5_step),
+        {
+            &C_icon_crossmark,
+            "Cancel",
+        });
+
+UX_FLOW(ux_clear_address_book_flow,
+        &ux_clear_address_book_flow_1_step,
+        &ux_clear_address_book_flow_2_step,
+        &ux_clear_address_book_flow_3_step
+);
+
+UX_STEP_NOCB(
+        ux_policy_flow_1_step,
+        pnn,
+        {
+            &C_icon_eye,
+            "Set approval",
+            "policy",
+        });
+
+UX_STEP_NOCB_INIT(
+        ux_policy_flow_2_step,
+        bnnn_paging,
+        update_policy_value(stack_slot),
+        {
+            "Recipients",
+            fieldValue,
+        });
+
+UX_STEP_NOCB_INIT(
+        ux_policy_flow_3_step,
+        bnnn_paging,
+        update_policy_value(stack_slot),
+        {
+            "Max amount",
+            fieldValue,
+        });
+
+UX_STEP_NOCB_INIT(
+        ux_policy_flow_4_step,
+        bnnn_paging,
+        update_policy_value(stack_slot),
+        {
+            "Max fee",
+            fieldValue,
+        });
+
+UX_STEP_NOCB_INIT(
+        ux_policy_flow_5_step,
+        bnnn_paging,
+        update_policy_value(stack_slot),
+        {
+            "Period cap",
+            fieldValue,
+        });
+
+UX_STEP_VALID(
+        ux_policy_flow_6_step,
+        pb,
+        policyApprovalAction(),
+        {
+            &C_icon_validate_14,
+            "Approve",
+        });
+
+UX_STEP_VALID(
+        ux_policy_flow_7_step,
+        pb,
+        policyRejectionAction(),
+        {
+            &C_icon_crossmark,
+            "Reject",
+        });
+
+UX_FLOW(ux_policy_flow,
+        &ux_policy_flow_1_step,
+        &ux_policy_flow_2_step,
+        &ux_policy_flow_3_step,
+        &ux_policy_flow_4_step,
+        &ux_policy_flow_5_step,
+        &ux_policy_flow_6_step,
+        &ux_policy_flow_7_step
+);
+
+static void update_labels() {
+    strncpy(summaryReviewLabel, N_storage.settings.summaryReview ? LABEL_ENABLED : LABEL_DISABLED, sizeof(summaryReviewLabel));
+    strncpy(preDeriveKeyLabel, N_storage.settings.preDeriveKey ? LABEL_ENABLED : LABEL_DISABLED, sizeof(preDeriveKeyLabel));
+    snprintf(chunkSizeLabel, sizeof(chunkSizeLabel), "%d bytes", N_storage.settings.chunkSize);
+    strncpy(publicKeyCacheLabel, N_storage.settings.publicKeyCache ? LABEL_ENABLED : LABEL_DISABLED, sizeof(publicKeyCacheLabel));
+    uint16_t contacts = count_contacts();
+    snprintf(addressBookLabel, sizeof(addressBookLabel), "%d contact%s", contacts, contacts == 1 ? "" : "s");
+    if (N_storage.policy.periodLength == 0) {
+        strncpy(policyLabel, LABEL_NOT_SET, sizeof(policyLabel));
+    } else {
+        strncpy(policyLabel, N_storage.policy.enabled ? LABEL_ENABLED : LABEL_DISABLED, sizeof(policyLabel));
+    }
+}
+
+// Persist the new settings and redisplay the step that was changed
+static void save_settings(const settings_t *settings, const ux_flow_step_t *step) {
+    write_settings(settings);
+    update_labels();
+    ux_flow_init(0, ux_settings_flow, step);
+}
+
+static void toggle_summary_review() {
+    settings_t settings = N_storage.settings;
+    settings.summaryReview = !settings.summaryReview;
+    save_settings(&settings, &ux_settings_flow_1_step);
+}
+
+static void toggle_pre_derive_key() {
+    settings_t settings = N_storage.settings;
+    settings.preDeriveKey = !settings.preDeriveKey;
+    save_settings(&settings, &ux_settings_flow_2_step);
+}
+
+static void switch_chunk_size() {
+    settings_t settings = N_storage.settings;
+    switch (settings.chunkSize) {
+        case CHUNK_SIZE_LARGE:
+            settings.chunkSize = CHUNK_SIZE_MEDIUM;
+            break;
+        case CHUNK_SIZE_MEDIUM:
+            settings.chunkSize = CHUNK_SIZE_SMALL;
+            break;
+        default:
+            settings.chunkSize = CHUNK_SIZE_LARGE;
+            break;
+    }
+    save_settings(&settings, &ux_settings_flow_3_step);
+}
+
+static void toggle_public_key_cache() {
+    settings_t settings = N_storage.settings;
+    settings.publicKeyCache = !settings.publicKeyCache;
+    if (!settings.publicKeyCache) {
+        clear_public_key_cache();
+    }
+    save_settings(&settings, &ux_settings_flow_4_step);
+}
+
+static void display_clear_address_book() {
+    ux_flow_init(0, ux_clear_address_book_flow, NULL);
+}
+
+static void clear_contacts() {
+    clear_address_book();
+    update_labels();
+    ux_flow_init(0, ux_settings_flow, &ux_settings_flow_5_step);
+}
+
+// Policies are set with the SET APPROVAL POLICY command, then only enabled or disabled here
+static void toggle_policy() {
+    policy_t policy = N_storage.policy;
+    if (policy.periodLength != 0) {
+        policy.enabled = !policy.enabled;
+        write_policy(&policy);
+    }
+    update_labels();
+    ux_flow_init(0, ux_settings_flow, &ux_settings_flow_6_step);
+}
+
+// e.g. "1000 XEM per 24 hours"
+static void update_policy_value(int stackSlot) {
+    int pos;
+    memset(fieldValue, 0, MAX_FIELD_LEN);
+    switch (G_ux.flow_stack[stackSlot].index) {
+        case 1:
+            strncpy(fieldValue, reviewedPolicy->contactsOnly ? "Address book only" : "Any address", MAX_FIELD_LEN);
+            break;
+        case 2:
+            snprintf_token(fieldValue, MAX_FIELD_LEN, reviewedPolicy->maxAmount, 6, "XEM");
+            break;
+        case 3:
+            snprintf_token(fieldValue, MAX_FIELD_LEN, reviewedPolicy->maxFee, 6, "XEM");
+            break;
+        default:
+            pos = snprintf_token(fieldValue, MAX_FIELD_LEN, reviewedPolicy->periodCap, 6, "XEM");
+            if (pos > 0) {
+                uint32_t hours = reviewedPolicy->periodLength / 3600;
+                snprintf(fieldValue + pos, MAX_FIELD_LEN - pos, " per %d hour%s", (int) hours, hours == 1 ? "" : "s");
+            }
+            break;
+    }
+}
+
+void display_policy_confirmation_ui(const policy_t *policy, action_t onApprove, action_t onReject) {
+    reviewedPolicy = policy;
+    policyApprovalAction = onApprove;
+    policyRejectionAction = onReject;
+    ux_flow_init(0, ux_policy_flow, NULL);
+}
+
+void display_settings_menu() {
+    update_labels();
+    ux_flow_init(0, ux_settings_flow, NULL);
+}
@@ -0,0 +1,28 @@
+/*******************************************************************************
+*    NEM Wallet
+*    (c) 2020 Ledger
+*    (c) 2020 FDS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+#ifndef LEDGER_APP_NEM_SETTINGSMENU_H
+#define LEDGER_APP_NEM_SETTINGSMENU_H
+
+#include "common.h"
+#include "nem/policy.h"
+
+void display_settings_menu();
+// The policy must stay valid until one of the actions is called
+void display_policy_confirmation_ui(const policy_t *policy, action_t onApprove, action_t onReject);
+
+#endif //LEDGER_APP_NEM_SETTINGSMENU_H
@@ -19,10 +19,17 @@
 #include "review_menu.h"
 #include <os_io_seproxyhal.h>
 #include <ux.h>
+#include <stdio.h>
 #include "common.h"
 #include "nem/format/readers.h"
 #include "nem/format/fields.h"
 #include "nem/format/format.h"
+#include "nem/format/printers.h"
+#include "nem/format/summary.h"
+#include "nem/contacts.h"
+#include "storage/storage.h"
+#include "perf.h"
+#include "trace.h"
 #include "glyphs.h"
 
 char fieldName[MAX_FIELDNAME_LEN];
@@ -30,10 +37,23 @@ char fieldValue[MAX_FIELD_LEN];
 
 result_t *transaction;
 result_action_t approval_menu_callback;
+window_formatter_t windowFormatter;
+action_t approvalStepAction;
 
-const ux_flow_step_t* ux_review_flow[MAX_FIELD_COUNT + 3];
+const ux_flow_step_t* ux_review_flow[MAX_REVIEW_STEPS];
+// Steps windowedField to windowedField + windowCount - 1 review the windows of a long message
+uint8_t windowedField;
+uint8_t windowCount;
+
+summary_t summary;
+const ux_flow_step_t* ux_summary_flow[SUMMARY_MAX_PAGES + 4];
 
 static void update_content(int stackSlot);
+static void update_summary(int stackSlot);
+static void update_policy_recipient();
+static void update_policy_approval();
+static void enter_approval_step();
+static void display_detail_menu();
 
 UX_STEP_NOCB_INIT(
         ux_review_flow_step,
@@ -44,9 +64,61 @@ UX_STEP_NOCB_INIT(
             fieldValue
         });
 
+// Recipient of the address book, on one line
+UX_STEP_NOCB_INIT(
+        ux_review_flow_contact,
+        pnn,
+        update_content(stack_slot),
+        {
+            &C_icon_validate_14,
+            fieldName,
+            fieldValue
+        });
+
+UX_STEP_NOCB_INIT(
+        ux_summary_flow_step,
+        bnnn_paging,
+        update_summary(stack_slot),
+        {
+            fieldName,
+            fieldValue
+        });
+
 UX_STEP_VALID(
+        ux_summary_flow_details,
+        pb,
+        display_detail_menu(),
+        {
+            &C_icon_eye,
+            "Show details",
+        });
+
+// Recipient outside the address book, shown before a transaction within the policy
+UX_STEP_NOCB_INIT(
+        ux_policy_flow_recipient,
+        bnnn_paging,
+        update_policy_recipient(),
+        {
+            fieldName,
+            fieldValue
+        });
+
+// Transaction within the approval policy, e.g. "Send 5 XEM" to "Payroll"
+UX_STEP_CB_INIT(
+        ux_policy_flow_sign,
+        pnn,
+        update_policy_approval(),
+        approval_menu_callback(OPTION_SIGN),
+        {
+            &C_icon_validate_14,
+            fieldName,
+            fieldValue
+        });
+
+UX_STEP_CB_INIT(
         ux_review_flow_sign,
         pn,
+        enter_approval_step(),
         approval_menu_callback(OPTION_SIGN),
         {
             &C_icon_validate_14,
@@ -68,32 +140,151 @@ static void update_title(const field_t *field) {
 }
 
 
-static void update_value(const field_t *field) {
+static void update_value(const field_t *field, uint8_t window) {
     memset(fieldValue, 0, MAX_FIELD_LEN);
-    format_field(field, fieldValue);
+    if (windowFormatter == NULL || !windowFormatter(field, window, fieldValue)) {
+        format_field_window(transaction, field, window, fieldValue);
+    }
+}
+
+// Field reviewed by a step, and the window of the field
+static int step_field(int stepIndex, uint8_t *window) {
+    *window = 0;
+    if (stepIndex >= windowedField + windowCount) {
+        return stepIndex - windowCount + 1;
+    } else if (stepIndex >= windowedField) {
+        *window = stepIndex - windowedField;
+        return windowedField;
+    }
+    return stepIndex;
 }
 
 static void update_content(int stackSlot) {
+    PERF_START(PERF_FORMAT);
     int stepIndex = G_ux.flow_stack[stackSlot].index;
-    const field_t *field = &transaction->fields[stepIndex];
+    uint8_t window;
+    int fieldIndex = step_field(stepIndex, &window);
+    const field_t *field = &transaction->fields[fieldIndex];
     update_title(field);
-    update_value(field);
+    if (windowCount > 1 && fieldIndex == windowedField) {
+        // e.g. "Message 2/5"
+        size_t len = strlen(fieldName);
+        snprintf(fieldName + len, MAX_FIELDNAME_LEN - len, " %d/%d", window + 1, windowCount);
+    }
+    update_value(field, window);
+    TRACE(TRACE_FIELD, field->id, stepIndex);
+    PERF_STOP(PERF_FORMAT);
+}
+
+static void update_summary(int stackSlot) {
+    int stepIndex = G_ux.flow_stack[stackSlot].index;
+    memset(fieldName, 0, MAX_FIELDNAME_LEN);
+    memset(fieldValue, 0, MAX_FIELD_LEN);
+    format_summary_page(&summary, stepIndex, fieldName, fieldValue);
 #ifdef HAVE_PRINTF
-    PRINTF("\nPage %d - Title: %s - Value: %s\n", stepIndex, fieldName, fieldValue);
+    PRINTF("\nSummary %d - Title: %s - Value: %s\n", stepIndex, fieldName, fieldValue);
 #endif
 }
 
+static void enter_approval_step() {
+    if (approvalStepAction != NULL) {
+        approvalStepAction();
+    }
+}
+
+static void update_policy_recipient() {
+    memset(fieldName, 0, MAX_FIELDNAME_LEN);
+    memset(fieldValue, 0, MAX_FIELD_LEN);
+    resolve_fieldname(summary.recipient, fieldName);
+    format_field(transaction, summary.recipient, fieldValue);
+}
+
+static void update_policy_approval() {
+    enter_approval_step();
+    const field_t *recipient = summary.recipient;
+    const char *label = find_contact(recipient->data, recipient->length);
+    int pos = snprintf(fieldName, MAX_FIELDNAME_LEN, "Send ");
+    snprintf_token(fieldName + pos, MAX_FIELDNAME_LEN - pos, summary.amount, 6, "XEM");
+    snprintf(fieldValue, MAX_FIELD_LEN, "%s", label != NULL ? label : "within policy");
+}
+
+static void display_detail_menu() {
+    // Only the first long message is windowed, a transaction has a single message
+    windowedField = 0;
+    windowCount = 1;
+    for (uint8_t i = 0; i < transaction->numFields; ++i) {
+        uint8_t count = format_window_count(&transaction->fields[i]);
+        if (count > 1) {
+            windowedField = i;
+            windowCount = count;
+            break;
+        }
+    }
+
+    int numSteps = transaction->numFields + windowCount - 1;
+    for (int i = 0; i < numSteps; ++i) {
+        uint8_t window;
+        const field_t *field = &transaction->fields[step_field(i, &window)];
+        ux_review_flow[i] = field->id == NEM_STR_RECIPIENT_CONTACT ? &ux_review_flow_contact : &ux_review_flow_step;
+    }
+
+    ux_review_flow[numSteps + 0] = &ux_review_flow_sign;
+    ux_review_flow[numSteps + 1] = &ux_review_flow_reject;
+    ux_review_flow[numSteps + 2] = FLOW_END_STEP;
+
+    ux_flow_init(0, ux_review_flow, NULL);
+}
+
+static void display_summary_menu() {
+    for (int i = 0; i < summary.numPages; ++i) {
+        ux_summary_flow[i] = &ux_summary_flow_step;
+    }
+
+    ux_summary_flow[summary.numPages + 0] = &ux_summary_flow_details;
+    ux_summary_flow[summary.numPages + 1] = &ux_review_flow_sign;
+    ux_summary_flow[summary.numPages + 2] = &ux_review_flow_reject;
+    ux_summary_flow[summary.numPages + 3] = FLOW_END_STEP;
+
+    ux_flow_init(0, ux_summary_flow, NULL);
+}
+
+static void display_policy_menu() {
+    uint8_t step = 0;
+    // Addresses without a label of the address book are shown in full before the approval
+    if (find_contact(summary.recipient->data, summary.recipient->length) == NULL) {
+        ux_summary_flow[step++] = &ux_policy_flow_recipient;
+    }
+    ux_summary_flow[step++] = &ux_policy_flow_sign;
+    ux_summary_flow[step++] = &ux_summary_flow_details;
+    ux_summary_flow[step++] = &ux_review_flow_reject;
+    ux_summary_flow[step] = FLOW_END_STEP;
+
+    ux_flow_init(0, ux_summary_flow, NULL);
+}
+
 void display_review_menu(result_t *transactionParam, result_action_t callback) {
     transaction = transactionParam;
     approval_menu_callback = callback;
 
-    for (int i = 0; i < transaction->numFields; ++i) {
-        ux_review_flow[i] = &ux_review_flow_step;
+    // Transfers within the approval policy are approved on a single screen. Fall back to
+    // the field by field review if the transaction cannot be summarized.
+    if (transaction->withinPolicy && build_summary(transaction, &summary) == E_SUCCESS) {
+        display_policy_menu();
+    } else if (N_storage.settings.summaryReview && build_summary(transaction, &summary) == E_SUCCESS) {
+        display_summary_menu();
+    } else {
+        display_detail_menu();
     }
+}
 
-    ux_review_flow[transaction->numFields + 0] = &ux_review_flow_sign;
-    ux_review_flow[transaction->numFields + 1] = &ux_review_flow_reject;
-    ux_review_flow[transaction->numFields + 2] = FLOW_END_STEP;
+void set_window_formatter(window_formatter_t formatter) {
+    windowFormatter = formatter;
+}
 
-    ux_flow_init(0, ux_review_flow, NULL);
+void set_approval_step_action(action_t action) {
+    approvalStepAction = action;
+}
+
+void refresh_review_menu() {
+    ux_flow_relayout();
 }
@@ -18,11 +18,23 @@
 #ifndef LEDGER_APP_NEM_REVIEWMENU_H
 #define LEDGER_APP_NEM_REVIEWMENU_H
 
+#include <stdbool.h>
 #include "transaction/transaction.h"
 
 #define OPTION_SIGN 0
 #define OPTION_REJECT 1
+// Fields, message windows and the closing steps of the field by field review
+#define MAX_REVIEW_STEPS (MAX_FIELD_COUNT + MAX_MESSAGE_WINDOWS + 3)
+
+// Formats a window of a field whose data is not on the device, returns false for the other fields
+typedef bool (*window_formatter_t)(const field_t *field, uint8_t window, char *dst);
 
 void display_review_menu(result_t *transactionParam, result_action_t callback);
+// Used by the following reviews, NULL when all the fields are in the transaction
+void set_window_formatter(window_formatter_t formatter);
+// Run by the following reviews each time their approval step is displayed, may be NULL
+void set_approval_step_action(action_t action);
+// Display the current step again, e.g. once the data of its window has been received
+void refresh_review_menu();
 
 #endif //LEDGER_APP_NEM_REVIEWMENU_H
@@ -0,0 +1,335 @@
+// Drives APDU scripts through handle_apdu() on the host and reports the
+// latency and throughput of each instruction.
+//
+// Script format: one command per line, "<apdu hex> [<expected status word hex>]".
+// Empty lines and lines starting with '#' are ignored. Reviews are approved
+// (or rejected with -r) by walking the displayed flow like a user would.
+// "pull <hex>" sets the message payload sent when the device requests windows
+// of the message of a multisig signature (P2 02 of SIGN).
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <ux.h>
+#include <glyphs.h>
+#include "host_sdk.h"
+#include "apdu/entry.h"
+#include "apdu/messages/sign_transaction.h"
+#include "apdu/constants.h"
+#include "limitations.h"
+#include "storage/storage.h"
+#include "ui/other/loading.h"
+
+#define MAX_LINE_LEN 4096
+// Upper bound on button presses to get a reply from a review flow
+#define MAX_UX_ACTIONS 8
+
+typedef struct {
+    unsigned int count;
+    unsigned long long bytes;
+    unsigned long long totalNs;
+    unsigned long long minNs;
+    unsigned long long maxNs;
+} ins_stats_t;
+
+static ins_stats_t stats[256];
+static bool verbose;
+static bool reject;
+static bool showDetails;
+static uint8_t pullPayload[MAX_MESSAGE_LEN];
+static unsigned int pullPayloadLength;
+
+// The device displays a spinner before running the action, the host runs it right away
+void execute_async(action_t actionToLoad, char *message) {
+    UNUSED(message);
+    actionToLoad();
+}
+
+static unsigned long long now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long) ts.tv_sec * 1000000000ULL + (unsigned long long) ts.tv_nsec;
+}
+
+static int parse_hex(const char *hex, uint8_t *out, size_t outSize) {
+    size_t len = strlen(hex);
+    if (len % 2 != 0 || len / 2 > outSize) {
+        return -1;
+    }
+    for (size_t i = 0; i < len / 2; i++) {
+        unsigned int byte;
+        if (sscanf(hex + 2 * i, "%2x", &byte) != 1) {
+            return -1;
+        }
+        out[i] = (uint8_t) byte;
+    }
+    return (int) (len / 2);
+}
+
+static void print_step(const ux_flow_step_t *step) {
+    // pb, pn and pnn layouts start with an icon
+    unsigned int first = (step->layout == UX_LAYOUT_pb || step->layout == UX_LAYOUT_pn ||
+                          step->layout == UX_LAYOUT_pnn) ? 1 : 0;
+    printf("    [%s]", step->name);
+    for (unsigned int i = first; i < step->params_count; i++) {
+        printf(" %s |", (const char *) step->params[i]);
+    }
+    printf("\n");
+}
+
+// Show every step of the current flow from the current one, then press the approve,
+// reject or details step. Stops at a step that waits for data from the host.
+static void press_review_button(void) {
+    ux_flow_state_t *flow = &G_ux.flow_stack[0];
+    const bagl_icon_details_t *wanted = reject ? &C_icon_crossmark : &C_icon_validate_14;
+    int choice = -1;
+
+    for (unsigned short i = flow->index; i < flow->length; i++) {
+        const ux_flow_step_t *step = flow->steps[i];
+        flow->index = i;
+        if (step->init != NULL) {
+            step->init(0);
+        }
+        // The device sends the requests of the review once the event is processed
+        send_window_request();
+        if (host_response_sent) {
+            return;
+        }
+        if (verbose) {
+            print_step(step);
+        }
+        if (step->validate == NULL || step->params_count == 0) {
+            continue;
+        }
+        if (step->params[0] == &C_icon_eye && showDetails) {
+            choice = i;
+            break;
+        }
+        if (step->params[0] == wanted && choice < 0) {
+            choice = i;
+        }
+    }
+    if (choice < 0) {
+        fprintf(stderr, "no %s step in the displayed flow\n", reject ? "reject" : "approve");
+        exit(EXIT_FAILURE);
+    }
+    if (flow->steps[choice]->params[0] == &C_icon_eye) {
+        showDetails = false;
+    }
+    flow->index = choice;
+    flow->steps[choice]->validate();
+}
+
+// Returns the status word of the response
+static uint16_t send_apdu(const uint8_t *apdu, unsigned int length) {
+    volatile unsigned int flags = 0;
+    volatile unsigned int tx = 0;
+    bool details = showDetails;
+
+    host_clear_response();
+    memset(G_io_apdu_buffer, 0, IO_APDU_BUFFER_SIZE);
+    memcpy(G_io_apdu_buffer, apdu, length);
+    handle_apdu(&flags, &tx);
+
+    if (flags & IO_ASYNCH_REPLY) {
+        for (unsigned int i = 0; i < MAX_UX_ACTIONS && !host_response_sent; i++) {
+            BEGIN_TRY {
+                TRY {
+                    press_review_button();
+                }
+                CATCH_OTHER(e) {
+                    // Exceptions of UX callbacks end up in the main loop on the device
+                    G_io_apdu_buffer[0] = e >> 8u;
+                    G_io_apdu_buffer[1] = e;
+                    io_exchange(CHANNEL_APDU | IO_RETURN_AFTER_TX, 2);
+                }
+                FINALLY {
+                }
+            }
+            END_TRY;
+        }
+        showDetails = details;
+    } else {
+        memcpy(host_response, G_io_apdu_buffer, tx);
+        host_response_length = tx;
+    }
+
+    if (host_response_length < 2) {
+        fprintf(stderr, "no response to the command\n");
+        exit(EXIT_FAILURE);
+    }
+    return (uint16_t) ((host_response[host_response_length - 2] << 8u) | host_response[host_response_length - 1]);
+}
+
+// Send the command, then the message windows requested by the device in reply
+static uint16_t exchange(const uint8_t *apdu, unsigned int length) {
+    uint8_t window[IO_APDU_BUFFER_SIZE] = {CLA, INS_SIGN, P1_MASK_WINDOW, 0x00};
+    uint16_t sw = send_apdu(apdu, length);
+    // Offset (2 bytes) and length (1 byte) of the window
+    while (apdu[OFFSET_INS] == INS_SIGN && sw == 0x9000 && host_response_length == 3 + 2) {
+        unsigned int offset = (host_response[0] << 8u) | host_response[1];
+        unsigned int windowLength = host_response[2];
+        if (offset + windowLength > pullPayloadLength) {
+            fprintf(stderr, "window %u+%u out of the pulled message\n", offset, windowLength);
+            exit(EXIT_FAILURE);
+        }
+        if (verbose) {
+            printf("    window %u+%u\n", offset, windowLength);
+        }
+        window[OFFSET_LC] = windowLength;
+        memcpy(window + OFFSET_CDATA, pullPayload + offset, windowLength);
+        sw = send_apdu(window, OFFSET_CDATA + windowLength);
+    }
+    return sw;
+}
+
+static void update_stats(uint8_t ins, unsigned int length, unsigned long long elapsed) {
+    ins_stats_t *s = &stats[ins];
+    if (s->count == 0 || elapsed < s->minNs) {
+        s->minNs = elapsed;
+    }
+    if (elapsed > s->maxNs) {
+        s->maxNs = elapsed;
+    }
+    s->count++;
+    s->bytes += length;
+    s->totalNs += elapsed;
+}
+
+// Returns the number of unexpected status words
+static int run_script(const char *filename) {
+    char line[MAX_LINE_LEN];
+    uint8_t apdu[IO_APDU_BUFFER_SIZE];
+    int failures = 0;
+    unsigned int lineNumber = 0;
+
+    FILE *f = fopen(filename, "r");
+    if (f == NULL) {
+        perror(filename);
+        exit(EXIT_FAILURE);
+    }
+    while (fgets(line, sizeof(line), f) != NULL) {
+        char command[MAX_LINE_LEN];
+        char expected[MAX_LINE_LEN];
+        lineNumber++;
+        int fieldCount = sscanf(line, "%4095s %4095s", command, expected);
+        if (fieldCount < 1 || command[0] == '#') {
+            continue;
+        }
+        if (strcmp(command, "pull") == 0) {
+            int payloadLength = fieldCount == 2 ? parse_hex(expected, pullPayload, sizeof(pullPayload)) : -1;
+            if (payloadLength < 0) {
+                fprintf(stderr, "%s:%u: invalid message\n", filename, lineNumber);
+                exit(EXIT_FAILURE);
+            }
+            pullPayloadLength = (unsigned int) payloadLength;
+            continue;
+        }
+        int length = parse_hex(command, apdu, sizeof(apdu));
+        if (length < OFFSET_CDATA) {
+            fprintf(stderr, "%s:%u: invalid APDU\n", filename, lineNumber);
+            exit(EXIT_FAILURE);
+        }
+
+        unsigned long long start = now_ns();
+        uint16_t sw = exchange(apdu, (unsigned int) length);
+        update_stats(apdu[OFFSET_INS], (unsigned int) length, now_ns() - start);
+
+        if (verbose) {
+            printf("=> %s\n<= ", command);
+            for (unsigned int i = 0; i < host_response_length; i++) {
+                printf("%02x", host_response[i]);
+            }
+            printf("\n");
+        }
+        if (fieldCount == 2 && strtoul(expected, NULL, 16) != sw) {
+            fprintf(stderr, "%s:%u: expected %s, got %04x\n", filename, lineNumber, expected, sw);
+            failures++;
+        }
+    }
+    fclose(f);
+    return failures;
+}
+
+static void print_report(void) {
+    printf("%-4s %8s %10s %12s %12s %12s %10s\n", "INS", "count", "bytes", "mean (us)", "min (us)", "max (us)", "KiB/s");
+    for (unsigned int ins = 0; ins < 256; ins++) {
+        const ins_stats_t *s = &stats[ins];
+        if (s->count == 0) {
+            continue;
+        }
+        double throughput = s->totalNs == 0 ? 0 : (double) s->bytes / 1024.0 / ((double) s->totalNs / 1e9);
+        printf("%02x   %8u %10llu %12.2f %12.2f %12.2f %10.1f\n", ins, s->count, s->bytes,
+               (double) s->totalNs / s->count / 1000.0, (double) s->minNs / 1000.0, (double) s->maxNs / 1000.0,
+               throughput);
+    }
+}
+
+static void usage(const char *name) {
+    fprintf(stderr, "usage: %s [-v] [-r] [-d] [-q] [-n repeat] [-s summary|prederive|cache]... script...\n"
+                    "  -v  print commands, responses and displayed steps\n"
+                    "  -r  reject reviews instead of approving them\n"
+                    "  -d  open the details of summarized reviews\n"
+                    "  -q  do not print the timing report\n"
+                    "  -n  run the scripts several times\n"
+                    "  -s  enable a setting\n", name);
+    exit(EXIT_FAILURE);
+}
+
+int main(int argc, char *argv[]) {
+    settings_t settings;
+    int repeat = 1;
+    bool report = true;
+    int failures = 0;
+    int opt;
+
+    init_storage();
+    memcpy(&settings, (const void *) &N_storage.settings, sizeof(settings_t));
+    while ((opt = getopt(argc, argv, "vrdqn:s:")) != -1) {
+        switch (opt) {
+            case 'v':
+                verbose = true;
+                break;
+            case 'r':
+                reject = true;
+                break;
+            case 'd':
+                showDetails = true;
+                break;
+            case 'q':
+                report = false;
+                break;
+            case 'n':
+                repeat = atoi(optarg);
+                break;
+            case 's':
+                if (strcmp(optarg, "summary") == 0) {
+                    settings.summaryReview = 1;
+                } else if (strcmp(optarg, "prederive") == 0) {
+                    settings.preDeriveKey = 1;
+                } else if (strcmp(optarg, "cache") == 0) {
+                    settings.publicKeyCache = 1;
+                } else {
+                    usage(argv[0]);
+                }
+                break;
+            default:
+                usage(argv[0]);
+        }
+    }
+    if (optind >= argc || repeat < 1) {
+        usage(argv[0]);
+    }
+    write_settings(&settings);
+
+    for (int i = 0; i < repeat; i++) {
+        for (int j = optind; j < argc; j++) {
+            failures += run_script(argv[j]);
+        }
+    }
+    if (report) {
+        print_report();
+    }
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,211 @@
+// Multi-threaded benchmark of the nem_parser library
+//
+// Every thread parses and formats the whole corpus in a loop with its own
+// result buffer. The run is repeated with 1, 2, 4... threads up to -t and the
+// aggregate throughput and the scaling efficiency are reported. The formatted
+// fields of every thread are compared with a single-threaded reference.
+#include <dirent.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "nem_parser.h"
+#include "nem_helpers.h"
+
+// Corpus read by default, CMake builds use the testcases/ of the source tree
+#ifndef TESTCASES_DIR
+#define TESTCASES_DIR "../testcases"
+#endif
+
+#define DEFAULT_ITERATIONS 10000
+
+typedef struct {
+    uint8_t *data;
+    uint32_t length;
+} transaction_t;
+
+typedef struct {
+    pthread_t thread;
+    unsigned long iterations;
+    bool validateOnly;
+    uint64_t checksum;
+    int failures;
+} worker_t;
+
+static transaction_t *corpus;
+static size_t corpusSize;
+
+static unsigned long long now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long) ts.tv_sec * 1000000000ULL + (unsigned long long) ts.tv_nsec;
+}
+
+static int is_raw_file(const struct dirent *entry) {
+    size_t len = strlen(entry->d_name);
+    return len > 4 && strcmp(entry->d_name + len - 4, ".raw") == 0;
+}
+
+// Load every transaction of the directory accepted by the parser
+static void load_corpus(const char *directory) {
+    struct dirent **entries;
+    int count = scandir(directory, &entries, is_raw_file, alphasort);
+    if (count <= 0) {
+        fprintf(stderr, "%s: no .raw transaction found\n", directory);
+        exit(EXIT_FAILURE);
+    }
+    corpus = calloc(count, sizeof(transaction_t));
+    for (int i = 0; i < count; i++) {
+        char path[PATH_MAX];
+        snprintf(path, sizeof(path), "%s/%s", directory, entries[i]->d_name);
+        FILE *f = fopen(path, "rb");
+        if (f == NULL) {
+            perror(path);
+            exit(EXIT_FAILURE);
+        }
+        fseek(f, 0, SEEK_END);
+        long size = ftell(f);
+        fseek(f, 0, SEEK_SET);
+        transaction_t *tx = &corpus[corpusSize];
+        tx->data = malloc(size == 0 ? 1 : size);
+        tx->length = (uint32_t) size;
+        if (tx->data == NULL || fread(tx->data, 1, size, f) != (size_t) size) {
+            fprintf(stderr, "%s: cannot read file\n", path);
+            exit(EXIT_FAILURE);
+        }
+        fclose(f);
+        if (nem_parser_validate(tx->data, tx->length, TESTNET, NULL) == 0) {
+            corpusSize++;
+        } else {
+            free(tx->data);
+        }
+        free(entries[i]);
+    }
+    free(entries);
+    if (corpusSize == 0) {
+        fprintf(stderr, "%s: no valid transaction\n", directory);
+        exit(EXIT_FAILURE);
+    }
+}
+
+// FNV-1a over the formatted fields
+static uint64_t hash_result(uint64_t hash, const nem_parser_result_t *result) {
+    for (uint8_t i = 0; i < result->numFields; i++) {
+        for (const char *c = result->fields[i].value; *c != '\0'; c++) {
+            hash = (hash ^ (uint8_t) *c) * 0x100000001B3ull;
+        }
+    }
+    return hash;
+}
+
+static void *run_worker(void *arg) {
+    worker_t *worker = arg;
+    nem_parser_result_t *result = malloc(sizeof(nem_parser_result_t));
+    worker->checksum = 0xCBF29CE484222325ull;
+    for (unsigned long n = 0; n < worker->iterations; n++) {
+        for (size_t i = 0; i < corpusSize; i++) {
+            const transaction_t *tx = &corpus[i];
+            if (worker->validateOnly) {
+                uint32_t signDataLength;
+                worker->failures += nem_parser_validate(tx->data, tx->length, TESTNET, &signDataLength) != 0;
+                worker->checksum += signDataLength;
+            } else {
+                worker->failures += nem_parser_parse(tx->data, tx->length, TESTNET, result) != 0;
+                // Checking the first pass is enough to catch shared state between threads
+                if (n == 0) {
+                    worker->checksum = hash_result(worker->checksum, result);
+                }
+            }
+        }
+    }
+    free(result);
+    return NULL;
+}
+
+// Returns the number of transactions per second, or a negative value if a thread got a different result
+static double run(unsigned int numThreads, unsigned long iterations, bool validateOnly, uint64_t *checksum) {
+    worker_t *workers = calloc(numThreads, sizeof(worker_t));
+    unsigned long long start = now_ns();
+    for (unsigned int i = 0; i < numThreads; i++) {
+        workers[i].iterations = iterations;
+        workers[i].validateOnly = validateOnly;
+        if (pthread_create(&workers[i].thread, NULL, run_worker, &workers[i]) != 0) {
+            perror("pthread_create");
+            exit(EXIT_FAILURE);
+        }
+    }
+    bool consistent = true;
+    for (unsigned int i = 0; i < numThreads; i++) {
+        pthread_join(workers[i].thread, NULL);
+        if (*checksum == 0) {
+            *checksum = workers[i].checksum;
+        }
+        consistent &= workers[i].failures == 0 && workers[i].checksum == *checksum;
+    }
+    double elapsed = (double) (now_ns() - start) / 1e9;
+    free(workers);
+    if (!consistent) {
+        return -1;
+    }
+    return (double) numThreads * iterations * corpusSize / elapsed;
+}
+
+int main(int argc, char *argv[]) {
+    const char *directory = TESTCASES_DIR;
+    unsigned long iterations = DEFAULT_ITERATIONS;
+    long maxThreads = sysconf(_SC_NPROCESSORS_ONLN);
+    bool validateOnly = false;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:t:V")) != -1) {
+        switch (opt) {
+            case 'n':
+                iterations = strtoul(optarg, NULL, 10);
+                break;
+            case 't':
+                maxThreads = strtol(optarg, NULL, 10);
+                break;
+            case 'V':
+                validateOnly = true;
+                break;
+            default:
+                fprintf(stderr, "usage: %s [-V] [-n iterations] [-t max threads] [testcases directory]\n"
+                                "  -V  validate only, do not format the fields\n", argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+    if (optind < argc) {
+        directory = argv[optind];
+    }
+    if (iterations == 0) {
+        iterations = 1;
+    }
+    if (maxThreads < 1) {
+        maxThreads = 1;
+    }
+    load_corpus(directory);
+
+    uint64_t checksum = 0;
+    double single = 0;
+    printf("%zu transactions, %lu iterations per thread\n", corpusSize, iterations);
+    printf("%8s %14s %10s %12s\n", "threads", "tx/s", "speedup", "efficiency");
+    for (long threads = 1; threads <= maxThreads; threads = threads * 2 > maxThreads && threads != maxThreads ?
+                                                                  maxThreads : threads * 2) {
+        double throughput = run((unsigned int) threads, iterations, validateOnly, &checksum);
+        if (throughput < 0) {
+            fprintf(stderr, "%ld threads: results differ from the single-threaded run\n", threads);
+            return EXIT_FAILURE;
+        }
+        if (threads == 1) {
+            single = throughput;
+        }
+        printf("%8ld %14.0f %10.2f %11.0f%%\n", threads, throughput, throughput / single,
+               100.0 * throughput / single / threads);
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,205 @@
+// Micro-benchmark of the parser and formatter over the transactions of testcases/
+//
+// For every corpus file, parse_txn_context() and resolve_fieldname()/format_field()
+// are run in a loop and the time per transaction, per field and the parsing
+// throughput are reported, as a table or as JSON (-j) to track regressions.
+#include <dirent.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "parse/nem_parse.h"
+#include "format/format.h"
+
+// Set by CMake to the testcases/ of the source tree, so the benchmark runs from any folder
+#ifndef TESTCASES_DIR
+#define TESTCASES_DIR "../testcases"
+#endif
+
+#define DEFAULT_ITERATIONS 1000000
+#define MAX_TYPE_LEN 64
+
+typedef struct {
+    char type[MAX_TYPE_LEN];
+    size_t bytes;
+    uint8_t numFields;
+    double parseNs;
+    double formatNs;
+} bench_result_t;
+
+// Keeps the compiler from optimizing the benchmarked calls away
+static volatile uint32_t sink;
+
+static unsigned long long now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long) ts.tv_sec * 1000000000ULL + (unsigned long long) ts.tv_nsec;
+}
+
+static uint8_t *load_file(const char *filename, size_t *size) {
+    FILE *f = fopen(filename, "rb");
+    if (f == NULL) {
+        perror(filename);
+        exit(EXIT_FAILURE);
+    }
+    fseek(f, 0, SEEK_END);
+    long filesize = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    uint8_t *data = malloc(filesize);
+    if (data == NULL || fread(data, 1, filesize, f) != (size_t) filesize) {
+        fprintf(stderr, "%s: cannot read file\n", filename);
+        exit(EXIT_FAILURE);
+    }
+    fclose(f);
+    *size = (size_t) filesize;
+    return data;
+}
+
+static int parse(parse_context_t *context, uint8_t *data, size_t size) {
+    context->data = data;
+    context->length = (uint32_t) size;
+    context->offset = 0;
+    context->result.numFields = 0;
+    return parse_txn_context(context);
+}
+
+// e.g. "Multisig TX / Transfer TX"
+static void describe_transaction(const result_t *result, char *type) {
+    char value[MAX_FIELD_LEN];
+    size_t pos = 0;
+    type[0] = '\0';
+    for (uint8_t i = 0; i < result->numFields; i++) {
+        const field_t *field = &result->fields[i];
+        if (field->id != NEM_UINT32_TRANSACTION_TYPE && field->id != NEM_UINT32_INNER_TRANSACTION_TYPE &&
+            field->id != NEM_UINT32_DETAIL_TRANSACTION_TYPE) {
+            continue;
+        }
+        memset(value, 0, sizeof(value));
+        format_field(result, field, value);
+        pos += snprintf(type + pos, MAX_TYPE_LEN - pos, "%s%s", pos == 0 ? "" : " / ", value);
+        if (pos >= MAX_TYPE_LEN) {
+            break;
+        }
+    }
+}
+
+// Returns false if the transaction cannot be parsed
+static bool bench_file(const char *filename, unsigned long iterations, bench_result_t *bench) {
+    parse_context_t context;
+    char fieldName[MAX_FIELDNAME_LEN];
+    char fieldValue[MAX_FIELD_LEN];
+    uint8_t *data = load_file(filename, &bench->bytes);
+
+    memset(&context, 0, sizeof(context));
+    if (parse(&context, data, bench->bytes) != 0) {
+        fprintf(stderr, "%s: cannot parse transaction, skipped\n", filename);
+        free(data);
+        return false;
+    }
+    bench->numFields = context.result.numFields;
+    describe_transaction(&context.result, bench->type);
+
+    unsigned long long start = now_ns();
+    for (unsigned long i = 0; i < iterations; i++) {
+        sink += parse(&context, data, bench->bytes) + context.result.numFields;
+    }
+    bench->parseNs = (double) (now_ns() - start) / iterations;
+
+    start = now_ns();
+    for (unsigned long i = 0; i < iterations; i++) {
+        for (uint8_t j = 0; j < context.result.numFields; j++) {
+            const field_t *field = &context.result.fields[j];
+            resolve_fieldname(field, fieldName);
+            format_field(&context.result, field, fieldValue);
+            sink += (uint8_t) fieldName[0] + (uint8_t) fieldValue[0];
+        }
+    }
+    bench->formatNs = (double) (now_ns() - start) / iterations;
+    free(data);
+    return true;
+}
+
+static int is_raw_file(const struct dirent *entry) {
+    size_t len = strlen(entry->d_name);
+    return len > 4 && strcmp(entry->d_name + len - 4, ".raw") == 0;
+}
+
+static void print_table_row(const char *name, const bench_result_t *bench) {
+    printf("%-46s %-40s %6zu %6u %12.1f %12.1f %12.1f %10.2f\n", name, bench->type, bench->bytes,
+           bench->numFields, bench->parseNs, bench->formatNs, bench->formatNs / bench->numFields,
+           bench->bytes / bench->parseNs * 1e9 / (1024 * 1024));
+}
+
+static void print_json_entry(const char *name, const bench_result_t *bench, bool first) {
+    printf("%s    {\"file\": \"%s\", \"type\": \"%s\", \"bytes\": %zu, \"fields\": %u, "
+           "\"parse_ns_per_tx\": %.1f, \"format_ns_per_tx\": %.1f, \"format_ns_per_field\": %.1f, "
+           "\"ns_per_tx\": %.1f, \"parse_bytes_per_sec\": %.0f}",
+           first ? "" : ",\n", name, bench->type, bench->bytes, bench->numFields, bench->parseNs, bench->formatNs,
+           bench->formatNs / bench->numFields, bench->parseNs + bench->formatNs,
+           bench->bytes / bench->parseNs * 1e9);
+}
+
+int main(int argc, char *argv[]) {
+    const char *directory = TESTCASES_DIR;
+    unsigned long iterations = DEFAULT_ITERATIONS;
+    bool json = false;
+    struct dirent **entries;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "jn:")) != -1) {
+        switch (opt) {
+            case 'j':
+                json = true;
+                break;
+            case 'n':
+                iterations = strtoul(optarg, NULL, 10);
+                break;
+            default:
+                fprintf(stderr, "usage: %s [-j] [-n iterations] [testcases directory]\n", argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+    if (optind < argc) {
+        directory = argv[optind];
+    }
+    if (iterations == 0) {
+        iterations = 1;
+    }
+
+    int count = scandir(directory, &entries, is_raw_file, alphasort);
+    if (count <= 0) {
+        fprintf(stderr, "%s: no .raw transaction found\n", directory);
+        return EXIT_FAILURE;
+    }
+
+    if (json) {
+        printf("{\n  \"iterations\": %lu,\n  \"results\": [\n", iterations);
+    } else {
+        printf("%-46s %-40s %6s %6s %12s %12s %12s %10s\n", "file", "type", "bytes", "fields",
+               "parse ns/tx", "format ns/tx", "ns/field", "parse MiB/s");
+    }
+    int printed = 0;
+    for (int i = 0; i < count; i++) {
+        char path[PATH_MAX];
+        bench_result_t bench;
+        snprintf(path, sizeof(path), "%s/%s", directory, entries[i]->d_name);
+        if (bench_file(path, iterations, &bench)) {
+            if (json) {
+                print_json_entry(entries[i]->d_name, &bench, printed == 0);
+            } else {
+                print_table_row(entries[i]->d_name, &bench);
+            }
+            printed++;
+        }
+        free(entries[i]);
+    }
+    free(entries);
+    if (json) {
+        printf("\n  ]\n}\n");
+    }
+    return EXIT_SUCCESS;
+}
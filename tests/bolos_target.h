@@ -1,3 +1,6 @@
 #pragma once
 
+// Host builds target the Nano X unless TARGET_NANOS or TARGET_NANOS2 is defined
+#if !defined(TARGET_NANOS) && !defined(TARGET_NANOS2) && !defined(TARGET_NANOX)
 #define TARGET_NANOX
+#endif
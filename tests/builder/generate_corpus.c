@@ -0,0 +1,66 @@
+// Writes random valid transactions as .raw files, e.g. to benchmark or fuzz
+// the parser on a larger corpus than testcases/
+#include <errno.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "transaction_generator.h"
+
+#define DEFAULT_COUNT 1000
+#define MAX_TRANSACTION_SIZE 4096
+
+static void usage(const char *name) {
+    fprintf(stderr, "usage: %s [-s seed] [-n count] directory\n", name);
+    exit(EXIT_FAILURE);
+}
+
+int main(int argc, char *argv[]) {
+    uint8_t buffer[MAX_TRANSACTION_SIZE];
+    unsigned long long seed = 1;
+    unsigned long count = DEFAULT_COUNT;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "s:n:")) != -1) {
+        switch (opt) {
+            case 's':
+                seed = strtoull(optarg, NULL, 0);
+                break;
+            case 'n':
+                count = strtoul(optarg, NULL, 10);
+                break;
+            default:
+                usage(argv[0]);
+        }
+    }
+    if (optind + 1 != argc) {
+        usage(argv[0]);
+    }
+    const char *directory = argv[optind];
+    if (mkdir(directory, 0755) != 0 && errno != EEXIST) {
+        perror(directory);
+        return EXIT_FAILURE;
+    }
+
+    tx_generator_t generator;
+    tx_generator_init(&generator, seed);
+    for (unsigned long i = 0; i < count; i++) {
+        char path[PATH_MAX];
+        tx_builder_t builder;
+        tx_builder_init(&builder, buffer, sizeof(buffer));
+        tx_generate(&generator, &builder, NULL);
+        if (builder.overflow) {
+            fprintf(stderr, "transaction %lu does not fit in %d bytes\n", i, MAX_TRANSACTION_SIZE);
+            return EXIT_FAILURE;
+        }
+        snprintf(path, sizeof(path), "%s/generated_%06lu.raw", directory, i);
+        FILE *f = fopen(path, "wb");
+        if (f == NULL || fwrite(buffer, 1, builder.length, f) != builder.length) {
+            perror(path);
+            return EXIT_FAILURE;
+        }
+        fclose(f);
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,206 @@
+#include <string.h>
+#include "transaction_builder.h"
+
+void tx_builder_init(tx_builder_t *builder, uint8_t *buffer, uint32_t capacity) {
+    builder->buffer = buffer;
+    builder->capacity = capacity;
+    builder->length = 0;
+    builder->overflow = false;
+}
+
+void tx_put_bytes(tx_builder_t *builder, const void *data, uint32_t length) {
+    if (builder->overflow || length > builder->capacity - builder->length) {
+        builder->overflow = true;
+        return;
+    }
+    if (length > 0) {
+        memcpy(builder->buffer + builder->length, data, length);
+    }
+    builder->length += length;
+}
+
+void tx_put_uint8(tx_builder_t *builder, uint8_t value) {
+    tx_put_bytes(builder, &value, sizeof(value));
+}
+
+void tx_put_uint16(tx_builder_t *builder, uint16_t value) {
+    uint8_t bytes[2] = {value & 0xFFu, value >> 8u};
+    tx_put_bytes(builder, bytes, sizeof(bytes));
+}
+
+void tx_put_uint32(tx_builder_t *builder, uint32_t value) {
+    tx_put_uint16(builder, value & 0xFFFFu);
+    tx_put_uint16(builder, value >> 16u);
+}
+
+void tx_put_uint64(tx_builder_t *builder, uint64_t value) {
+    tx_put_uint32(builder, value & 0xFFFFFFFFu);
+    tx_put_uint32(builder, value >> 32u);
+}
+
+void tx_put_string(tx_builder_t *builder, const char *str) {
+    uint32_t length = strlen(str);
+    tx_put_uint32(builder, length);
+    tx_put_bytes(builder, str, length);
+}
+
+void tx_put_address(tx_builder_t *builder, const char *address) {
+    tx_put_uint32(builder, NEM_ADDRESS_LENGTH);
+    tx_put_bytes(builder, address, NEM_ADDRESS_LENGTH);
+}
+
+void tx_put_public_key(tx_builder_t *builder, const uint8_t *publicKey) {
+    tx_put_uint32(builder, NEM_PUBLIC_KEY_LENGTH);
+    tx_put_bytes(builder, publicKey, NEM_PUBLIC_KEY_LENGTH);
+}
+
+uint32_t tx_begin_struct(tx_builder_t *builder) {
+    uint32_t start = builder->length;
+    tx_put_uint32(builder, 0);
+    return start;
+}
+
+void tx_end_struct(tx_builder_t *builder, uint32_t start) {
+    if (builder->overflow) {
+        return;
+    }
+    uint32_t length = builder->length - start - sizeof(uint32_t);
+    builder->length = start;
+    tx_put_uint32(builder, length);
+    builder->length += length;
+}
+
+void tx_put_header(tx_builder_t *builder, uint32_t type, const tx_header_t *header) {
+    tx_put_uint32(builder, type);
+    // Version is (network << 24) | version
+    tx_put_uint8(builder, header->version);
+    tx_put_uint16(builder, 0);
+    tx_put_uint8(builder, header->networkType);
+    tx_put_uint32(builder, header->timestamp);
+    tx_put_public_key(builder, header->signer);
+    tx_put_uint64(builder, header->fee);
+    tx_put_uint32(builder, header->deadline);
+}
+
+// Mosaic id structure: namespace id and mosaic name
+static void put_mosaic_id(tx_builder_t *builder, const tx_mosaic_t *mosaic) {
+    uint32_t start = tx_begin_struct(builder);
+    tx_put_string(builder, mosaic->namespaceId);
+    tx_put_string(builder, mosaic->name);
+    tx_end_struct(builder, start);
+}
+
+void tx_build_transfer(tx_builder_t *builder, const tx_header_t *header, const tx_transfer_t *transfer) {
+    tx_put_header(builder, NEM_TXN_TRANSFER, header);
+    tx_put_address(builder, transfer->recipient);
+    tx_put_uint64(builder, transfer->amount);
+    if (transfer->message == NULL) {
+        tx_put_uint32(builder, 0);
+    } else {
+        uint32_t start = tx_begin_struct(builder);
+        tx_put_uint32(builder, transfer->messageType);
+        tx_put_uint32(builder, transfer->messageLength);
+        tx_put_bytes(builder, transfer->message, transfer->messageLength);
+        tx_end_struct(builder, start);
+    }
+    if (header->version == 2) {
+        tx_put_uint32(builder, transfer->numMosaics);
+        for (uint32_t i = 0; i < transfer->numMosaics; i++) {
+            uint32_t start = tx_begin_struct(builder);
+            put_mosaic_id(builder, &transfer->mosaics[i]);
+            tx_put_uint64(builder, transfer->mosaics[i].quantity);
+            tx_end_struct(builder, start);
+        }
+    }
+}
+
+void tx_build_importance_transfer(tx_builder_t *builder, const tx_header_t *header,
+                                  const tx_importance_transfer_t *transfer) {
+    tx_put_header(builder, NEM_TXN_IMPORTANCE_TRANSFER, header);
+    tx_put_uint32(builder, transfer->mode);
+    tx_put_public_key(builder, transfer->remote);
+}
+
+void tx_build_aggregate_modification(tx_builder_t *builder, const tx_header_t *header,
+                                     const tx_aggregate_modification_t *modification) {
+    tx_put_header(builder, NEM_TXN_MULTISIG_AGGREGATE_MODIFICATION, header);
+    tx_put_uint32(builder, modification->numModifications);
+    for (uint32_t i = 0; i < modification->numModifications; i++) {
+        uint32_t start = tx_begin_struct(builder);
+        tx_put_uint32(builder, modification->modifications[i].type);
+        tx_put_public_key(builder, modification->modifications[i].cosignatory);
+        tx_end_struct(builder, start);
+    }
+    if (header->version == 2) {
+        uint32_t start = tx_begin_struct(builder);
+        if (modification->hasMinCosignatories) {
+            tx_put_uint32(builder, (uint32_t) modification->minCosignatories);
+        }
+        tx_end_struct(builder, start);
+    }
+}
+
+void tx_build_provision_namespace(tx_builder_t *builder, const tx_header_t *header,
+                                  const tx_provision_namespace_t *provision) {
+    tx_put_header(builder, NEM_TXN_PROVISION_NAMESPACE, header);
+    tx_put_address(builder, provision->sink);
+    tx_put_uint64(builder, provision->rentalFee);
+    tx_put_string(builder, provision->newPart);
+    if (provision->parent == NULL) {
+        tx_put_uint32(builder, UINT32_MAX);
+    } else {
+        tx_put_string(builder, provision->parent);
+    }
+}
+
+void tx_build_mosaic_definition(tx_builder_t *builder, const tx_header_t *header,
+                                const tx_mosaic_definition_t *definition) {
+    const tx_mosaic_t id = {definition->namespaceId, definition->name, 0};
+    tx_put_header(builder, NEM_TXN_MOSAIC_DEFINITION, header);
+    uint32_t start = tx_begin_struct(builder);
+    tx_put_public_key(builder, definition->creator);
+    put_mosaic_id(builder, &id);
+    tx_put_string(builder, definition->description);
+    tx_put_uint32(builder, definition->numProperties);
+    for (uint32_t i = 0; i < definition->numProperties; i++) {
+        uint32_t property = tx_begin_struct(builder);
+        tx_put_string(builder, definition->properties[i].name);
+        tx_put_string(builder, definition->properties[i].value);
+        tx_end_struct(builder, property);
+    }
+    uint32_t levy = tx_begin_struct(builder);
+    if (definition->levy != NULL) {
+        tx_put_uint32(builder, definition->levy->feeType);
+        tx_put_address(builder, definition->levy->recipient);
+        put_mosaic_id(builder, &definition->levy->mosaic);
+        tx_put_uint64(builder, definition->levy->mosaic.quantity);
+    }
+    tx_end_struct(builder, levy);
+    tx_end_struct(builder, start);
+    tx_put_address(builder, definition->sink);
+    tx_put_uint64(builder, definition->creationFee);
+}
+
+void tx_build_supply_change(tx_builder_t *builder, const tx_header_t *header, const tx_supply_change_t *change) {
+    const tx_mosaic_t id = {change->namespaceId, change->name, 0};
+    tx_put_header(builder, NEM_TXN_MOSAIC_SUPPLY_CHANGE, header);
+    put_mosaic_id(builder, &id);
+    tx_put_uint32(builder, change->supplyType);
+    tx_put_uint64(builder, change->delta);
+}
+
+uint32_t tx_begin_multisig(tx_builder_t *builder, const tx_header_t *header) {
+    tx_put_header(builder, NEM_TXN_MULTISIG, header);
+    return tx_begin_struct(builder);
+}
+
+uint32_t tx_begin_multisig_signature(tx_builder_t *builder, const tx_header_t *header,
+                                     const uint8_t *hash, const char *multisigAddress) {
+    tx_put_header(builder, NEM_TXN_MULTISIG_SIGNATURE, header);
+    // Hash object: length of the hash and hash
+    tx_put_uint32(builder, sizeof(uint32_t) + NEM_TRANSACTION_HASH_LENGTH);
+    tx_put_uint32(builder, NEM_TRANSACTION_HASH_LENGTH);
+    tx_put_bytes(builder, hash, NEM_TRANSACTION_HASH_LENGTH);
+    tx_put_address(builder, multisigAddress);
+    return tx_begin_struct(builder);
+}
@@ -0,0 +1,148 @@
+// Serialization of NEM transactions with the layouts read by nem_parse.c
+//
+// Transactions are written in a caller provided buffer. Nested structures
+// (mosaic ids, properties, levy, inner transactions of multisig) are opened
+// with a reserved length prefix that is patched once their content is written.
+#ifndef TESTS_BUILDER_TRANSACTION_BUILDER_H
+#define TESTS_BUILDER_TRANSACTION_BUILDER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "nem_helpers.h"
+
+typedef struct tx_builder_t {
+    uint8_t *buffer;
+    uint32_t capacity;
+    uint32_t length;
+    // Set when a write did not fit in the buffer, the transaction is then truncated
+    bool overflow;
+} tx_builder_t;
+
+// Common header, the transaction type is set by the tx_build_* functions
+typedef struct tx_header_t {
+    uint8_t version;
+    uint8_t networkType;
+    uint32_t timestamp;
+    uint8_t signer[NEM_PUBLIC_KEY_LENGTH];
+    uint64_t fee;
+    uint32_t deadline;
+} tx_header_t;
+
+typedef struct tx_mosaic_t {
+    const char *namespaceId;
+    const char *name;
+    uint64_t quantity;
+} tx_mosaic_t;
+
+typedef struct tx_transfer_t {
+    // 40 characters, not NUL terminated
+    const char *recipient;
+    uint64_t amount;
+    // 1 for plain messages, 2 for encrypted ones
+    uint32_t messageType;
+    const uint8_t *message;
+    uint32_t messageLength;
+    // Only written in version 2
+    const tx_mosaic_t *mosaics;
+    uint32_t numMosaics;
+} tx_transfer_t;
+
+typedef struct tx_importance_transfer_t {
+    // 1 to activate, 2 to deactivate
+    uint32_t mode;
+    uint8_t remote[NEM_PUBLIC_KEY_LENGTH];
+} tx_importance_transfer_t;
+
+typedef struct tx_modification_t {
+    // 1 to add, 2 to delete a cosignatory
+    uint32_t type;
+    uint8_t cosignatory[NEM_PUBLIC_KEY_LENGTH];
+} tx_modification_t;
+
+typedef struct tx_aggregate_modification_t {
+    const tx_modification_t *modifications;
+    uint32_t numModifications;
+    // Only written in version 2
+    bool hasMinCosignatories;
+    int32_t minCosignatories;
+} tx_aggregate_modification_t;
+
+typedef struct tx_provision_namespace_t {
+    const char *sink;
+    uint64_t rentalFee;
+    const char *newPart;
+    // NULL for a root namespace
+    const char *parent;
+} tx_provision_namespace_t;
+
+typedef struct tx_property_t {
+    const char *name;
+    const char *value;
+} tx_property_t;
+
+typedef struct tx_levy_t {
+    // 1 for an absolute fee, 2 for a percentile one
+    uint32_t feeType;
+    const char *recipient;
+    // The quantity of the mosaic is the levy fee
+    tx_mosaic_t mosaic;
+} tx_levy_t;
+
+typedef struct tx_mosaic_definition_t {
+    uint8_t creator[NEM_PUBLIC_KEY_LENGTH];
+    const char *namespaceId;
+    const char *name;
+    const char *description;
+    const tx_property_t *properties;
+    uint32_t numProperties;
+    // NULL without levy
+    const tx_levy_t *levy;
+    const char *sink;
+    uint64_t creationFee;
+} tx_mosaic_definition_t;
+
+typedef struct tx_supply_change_t {
+    const char *namespaceId;
+    const char *name;
+    // 1 to create, 2 to delete supply
+    uint32_t supplyType;
+    uint64_t delta;
+} tx_supply_change_t;
+
+void tx_builder_init(tx_builder_t *builder, uint8_t *buffer, uint32_t capacity);
+
+// Little endian primitives
+void tx_put_bytes(tx_builder_t *builder, const void *data, uint32_t length);
+void tx_put_uint8(tx_builder_t *builder, uint8_t value);
+void tx_put_uint16(tx_builder_t *builder, uint16_t value);
+void tx_put_uint32(tx_builder_t *builder, uint32_t value);
+void tx_put_uint64(tx_builder_t *builder, uint64_t value);
+// Length prefixed string, address or public key
+void tx_put_string(tx_builder_t *builder, const char *str);
+void tx_put_address(tx_builder_t *builder, const char *address);
+void tx_put_public_key(tx_builder_t *builder, const uint8_t *publicKey);
+
+// Reserve the length prefix of a structure, returns the value to give to tx_end_struct()
+uint32_t tx_begin_struct(tx_builder_t *builder);
+void tx_end_struct(tx_builder_t *builder, uint32_t start);
+
+void tx_put_header(tx_builder_t *builder, uint32_t type, const tx_header_t *header);
+
+void tx_build_transfer(tx_builder_t *builder, const tx_header_t *header, const tx_transfer_t *transfer);
+void tx_build_importance_transfer(tx_builder_t *builder, const tx_header_t *header,
+                                  const tx_importance_transfer_t *transfer);
+void tx_build_aggregate_modification(tx_builder_t *builder, const tx_header_t *header,
+                                     const tx_aggregate_modification_t *modification);
+void tx_build_provision_namespace(tx_builder_t *builder, const tx_header_t *header,
+                                  const tx_provision_namespace_t *provision);
+void tx_build_mosaic_definition(tx_builder_t *builder, const tx_header_t *header,
+                                const tx_mosaic_definition_t *definition);
+void tx_build_supply_change(tx_builder_t *builder, const tx_header_t *header, const tx_supply_change_t *change);
+
+// Multisig transactions wrap the inner transaction built after them, close them with tx_end_struct()
+uint32_t tx_begin_multisig(tx_builder_t *builder, const tx_header_t *header);
+// The inner transaction of a signature is appended by the wallet, it is not part of the NEM layout
+uint32_t tx_begin_multisig_signature(tx_builder_t *builder, const tx_header_t *header,
+                                     const uint8_t *hash, const char *multisigAddress);
+
+#endif // TESTS_BUILDER_TRANSACTION_BUILDER_H
@@ -0,0 +1,320 @@
+#include <stdio.h>
+#include <string.h>
+#include "transaction_generator.h"
+
+// Bounds keeping the worst case within MAX_FIELD_COUNT and MAX_RAW_TX of the Nano S
+#define MAX_MOSAICS 4
+#define MAX_MODIFICATIONS 4
+#define MAX_MESSAGE_LEN 160
+#define MAX_NAMESPACE_LEN 16
+#define MAX_NAME_LEN 32
+#define MAX_DESCRIPTION_LEN 64
+#define MAX_FEE 100000000u
+
+static const char BASE32_ALPHABET[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ234567";
+static const char NAME_ALPHABET[] = "abcdefghijklmnopqrstuvwxyz0123456789_-";
+static const uint8_t NETWORK_TYPES[] = {MAINNET, TESTNET, MIJIN_MAINNET, MIJIN_TESTNET};
+static const char NETWORK_PREFIXES[] = "NTMS";
+
+static const uint32_t INNER_TYPES[] = {
+    NEM_TXN_TRANSFER,
+    NEM_TXN_IMPORTANCE_TRANSFER,
+    NEM_TXN_MULTISIG_AGGREGATE_MODIFICATION,
+    NEM_TXN_PROVISION_NAMESPACE,
+    NEM_TXN_MOSAIC_DEFINITION,
+    NEM_TXN_MOSAIC_SUPPLY_CHANGE
+};
+
+void tx_generator_init(tx_generator_t *generator, uint64_t seed) {
+    generator->state = seed;
+}
+
+// splitmix64
+uint64_t tx_random_uint64(tx_generator_t *generator) {
+    uint64_t z = (generator->state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30u)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27u)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31u);
+}
+
+uint32_t tx_random(tx_generator_t *generator, uint32_t bound) {
+    return (uint32_t) (tx_random_uint64(generator) % bound);
+}
+
+static void random_bytes(tx_generator_t *generator, uint8_t *out, uint32_t length) {
+    for (uint32_t i = 0; i < length; i++) {
+        out[i] = (uint8_t) tx_random(generator, 256);
+    }
+}
+
+// NUL terminated string of 1 to maxLength characters of the alphabet
+static void random_string(tx_generator_t *generator, char *out, uint32_t maxLength, const char *alphabet) {
+    uint32_t length = 1 + tx_random(generator, maxLength);
+    uint32_t size = strlen(alphabet);
+    for (uint32_t i = 0; i < length; i++) {
+        out[i] = alphabet[tx_random(generator, size)];
+    }
+    out[length] = '\0';
+}
+
+// Addresses are not checked by the parser, only their first character follows the network
+static void random_address(tx_generator_t *generator, uint8_t networkType, char *out) {
+    out[0] = 'T';
+    for (uint32_t i = 0; i < sizeof(NETWORK_TYPES); i++) {
+        if (NETWORK_TYPES[i] == networkType) {
+            out[0] = NETWORK_PREFIXES[i];
+        }
+    }
+    for (uint32_t i = 1; i < NEM_ADDRESS_LENGTH; i++) {
+        out[i] = BASE32_ALPHABET[tx_random(generator, 32)];
+    }
+}
+
+static void random_mosaic(tx_generator_t *generator, tx_mosaic_t *mosaic, char *namespaceId, char *name) {
+    if (tx_random(generator, 4) == 0) {
+        strcpy(namespaceId, STR_NEM);
+        strcpy(name, STR_XEM);
+    } else {
+        random_string(generator, namespaceId, MAX_NAMESPACE_LEN, NAME_ALPHABET);
+        random_string(generator, name, MAX_NAME_LEN, NAME_ALPHABET);
+    }
+    mosaic->namespaceId = namespaceId;
+    mosaic->name = name;
+    mosaic->quantity = tx_random_uint64(generator) >> (24u + tx_random(generator, 40));
+}
+
+static void random_header(tx_generator_t *generator, tx_header_t *header, uint8_t version, uint8_t networkType) {
+    header->version = version;
+    header->networkType = networkType;
+    header->timestamp = (uint32_t) tx_random_uint64(generator);
+    random_bytes(generator, header->signer, NEM_PUBLIC_KEY_LENGTH);
+    header->fee = tx_random(generator, MAX_FEE);
+    header->deadline = header->timestamp + 3600 * (1 + tx_random(generator, 24));
+}
+
+static void generate_transfer(tx_generator_t *generator, tx_builder_t *builder, const tx_header_t *header,
+                              tx_generated_t *generated) {
+    uint8_t message[MAX_MESSAGE_LEN];
+    tx_mosaic_t mosaics[MAX_MOSAICS];
+    char namespaceIds[MAX_MOSAICS][MAX_NAMESPACE_LEN + 1];
+    char names[MAX_MOSAICS][MAX_NAME_LEN + 1];
+    tx_transfer_t transfer = {0};
+
+    random_address(generator, header->networkType, generated->recipient);
+    generated->hasRecipient = true;
+    transfer.recipient = generated->recipient;
+    transfer.amount = tx_random_uint64(generator) >> (24u + tx_random(generator, 40));
+    switch (tx_random(generator, 4)) {
+        case 0:
+            break;
+        case 1:
+            // Plain text
+            transfer.messageType = 1;
+            transfer.messageLength = 1 + tx_random(generator, MAX_MESSAGE_LEN);
+            for (uint32_t i = 0; i < transfer.messageLength; i++) {
+                message[i] = (uint8_t) (' ' + tx_random(generator, '~' - ' ' + 1));
+            }
+            transfer.message = message;
+            break;
+        case 2:
+            // Hexadecimal message, starting with 0xFE
+            transfer.messageType = 1;
+            transfer.messageLength = 1 + tx_random(generator, MAX_MESSAGE_LEN / 2);
+            random_bytes(generator, message, transfer.messageLength);
+            message[0] = 0xFE;
+            transfer.message = message;
+            break;
+        default:
+            transfer.messageType = 2;
+            transfer.messageLength = 48 + 16 * tx_random(generator, (MAX_MESSAGE_LEN - 48) / 16);
+            random_bytes(generator, message, transfer.messageLength);
+            transfer.message = message;
+            break;
+    }
+    if (header->version == 2) {
+        transfer.numMosaics = tx_random(generator, MAX_MOSAICS + 1);
+        for (uint32_t i = 0; i < transfer.numMosaics; i++) {
+            random_mosaic(generator, &mosaics[i], namespaceIds[i], names[i]);
+        }
+        transfer.mosaics = mosaics;
+    }
+    tx_build_transfer(builder, header, &transfer);
+}
+
+static void generate_importance_transfer(tx_generator_t *generator, tx_builder_t *builder,
+                                         const tx_header_t *header) {
+    tx_importance_transfer_t transfer;
+    transfer.mode = 1 + tx_random(generator, 2);
+    random_bytes(generator, transfer.remote, NEM_PUBLIC_KEY_LENGTH);
+    tx_build_importance_transfer(builder, header, &transfer);
+}
+
+static void generate_aggregate_modification(tx_generator_t *generator, tx_builder_t *builder,
+                                            const tx_header_t *header) {
+    tx_modification_t modifications[MAX_MODIFICATIONS];
+    tx_aggregate_modification_t modification = {0};
+    modification.numModifications = tx_random(generator, MAX_MODIFICATIONS + 1);
+    for (uint32_t i = 0; i < modification.numModifications; i++) {
+        modifications[i].type = 1 + tx_random(generator, 2);
+        random_bytes(generator, modifications[i].cosignatory, NEM_PUBLIC_KEY_LENGTH);
+    }
+    modification.modifications = modifications;
+    modification.hasMinCosignatories = tx_random(generator, 2) == 0;
+    modification.minCosignatories = (int32_t) tx_random(generator, 7) - 3;
+    tx_build_aggregate_modification(builder, header, &modification);
+}
+
+static void generate_provision_namespace(tx_generator_t *generator, tx_builder_t *builder,
+                                         const tx_header_t *header) {
+    char sink[NEM_ADDRESS_LENGTH];
+    char newPart[MAX_NAMESPACE_LEN + 1];
+    char parent[MAX_NAMESPACE_LEN + 1];
+    tx_provision_namespace_t provision;
+    random_address(generator, header->networkType, sink);
+    random_string(generator, newPart, MAX_NAMESPACE_LEN, NAME_ALPHABET);
+    random_string(generator, parent, MAX_NAMESPACE_LEN, NAME_ALPHABET);
+    provision.sink = sink;
+    provision.newPart = newPart;
+    if (tx_random(generator, 2) == 0) {
+        provision.parent = NULL;
+        provision.rentalFee = 100000000;
+    } else {
+        provision.parent = parent;
+        provision.rentalFee = 10000000;
+    }
+    tx_build_provision_namespace(builder, header, &provision);
+}
+
+static void generate_mosaic_definition(tx_generator_t *generator, tx_builder_t *builder,
+                                       const tx_header_t *header) {
+    char namespaceId[MAX_NAMESPACE_LEN + 1];
+    char name[MAX_NAME_LEN + 1];
+    char description[MAX_DESCRIPTION_LEN + 1];
+    char divisibility[2];
+    char supply[21];
+    char sink[NEM_ADDRESS_LENGTH];
+    char levyRecipient[NEM_ADDRESS_LENGTH];
+    char levyNamespaceId[MAX_NAMESPACE_LEN + 1];
+    char levyName[MAX_NAME_LEN + 1];
+    tx_levy_t levy;
+    tx_mosaic_definition_t definition;
+    tx_property_t properties[] = {
+        {"divisibility", divisibility},
+        {"initialSupply", supply},
+        {"supplyMutable", "true"},
+        {"transferable", "true"}
+    };
+
+    snprintf(divisibility, sizeof(divisibility), "%u", tx_random(generator, 7));
+    snprintf(supply, sizeof(supply), "%u", tx_random(generator, 1000000000));
+    if (tx_random(generator, 2) == 0) {
+        properties[2].value = "false";
+    }
+    if (tx_random(generator, 2) == 0) {
+        properties[3].value = "false";
+    }
+    random_bytes(generator, definition.creator, NEM_PUBLIC_KEY_LENGTH);
+    random_string(generator, namespaceId, MAX_NAMESPACE_LEN, NAME_ALPHABET);
+    random_string(generator, name, MAX_NAME_LEN, NAME_ALPHABET);
+    random_string(generator, description, MAX_DESCRIPTION_LEN, NAME_ALPHABET);
+    definition.namespaceId = namespaceId;
+    definition.name = name;
+    definition.description = description;
+    definition.properties = properties;
+    definition.numProperties = tx_random(generator, sizeof(properties) / sizeof(properties[0]) + 1);
+    definition.levy = NULL;
+    if (tx_random(generator, 2) == 0) {
+        levy.feeType = 1 + tx_random(generator, 2);
+        random_address(generator, header->networkType, levyRecipient);
+        levy.recipient = levyRecipient;
+        random_mosaic(generator, &levy.mosaic, levyNamespaceId, levyName);
+        definition.levy = &levy;
+    }
+    random_address(generator, header->networkType, sink);
+    definition.sink = sink;
+    definition.creationFee = 10000000;
+    tx_build_mosaic_definition(builder, header, &definition);
+}
+
+static void generate_supply_change(tx_generator_t *generator, tx_builder_t *builder, const tx_header_t *header) {
+    char namespaceId[MAX_NAMESPACE_LEN + 1];
+    char name[MAX_NAME_LEN + 1];
+    tx_supply_change_t change;
+    random_string(generator, namespaceId, MAX_NAMESPACE_LEN, NAME_ALPHABET);
+    random_string(generator, name, MAX_NAME_LEN, NAME_ALPHABET);
+    change.namespaceId = namespaceId;
+    change.name = name;
+    change.supplyType = 1 + tx_random(generator, 2);
+    change.delta = tx_random(generator, 1000000000);
+    tx_build_supply_change(builder, header, &change);
+}
+
+// Any transaction but multisig and multisig signature
+static void generate_simple(tx_generator_t *generator, tx_builder_t *builder, uint32_t type, uint8_t networkType,
+                            tx_generated_t *generated) {
+    tx_header_t header;
+    uint8_t version = 1;
+    if (type == NEM_TXN_TRANSFER || type == NEM_TXN_MULTISIG_AGGREGATE_MODIFICATION) {
+        version = 1 + tx_random(generator, 2);
+    }
+    random_header(generator, &header, version, networkType);
+    generated->innerFee = header.fee;
+    switch (type) {
+        case NEM_TXN_TRANSFER:
+            generate_transfer(generator, builder, &header, generated);
+            break;
+        case NEM_TXN_IMPORTANCE_TRANSFER:
+            generate_importance_transfer(generator, builder, &header);
+            break;
+        case NEM_TXN_MULTISIG_AGGREGATE_MODIFICATION:
+            generate_aggregate_modification(generator, builder, &header);
+            break;
+        case NEM_TXN_PROVISION_NAMESPACE:
+            generate_provision_namespace(generator, builder, &header);
+            break;
+        case NEM_TXN_MOSAIC_DEFINITION:
+            generate_mosaic_definition(generator, builder, &header);
+            break;
+        default:
+            generate_supply_change(generator, builder, &header);
+            break;
+    }
+}
+
+void tx_generate(tx_generator_t *generator, tx_builder_t *builder, tx_generated_t *generated) {
+    tx_generated_t unused;
+    tx_header_t header;
+    uint8_t hash[NEM_TRANSACTION_HASH_LENGTH];
+    char multisigAddress[NEM_ADDRESS_LENGTH];
+    uint8_t networkType = NETWORK_TYPES[tx_random(generator, sizeof(NETWORK_TYPES))];
+    uint32_t innerType = INNER_TYPES[tx_random(generator, sizeof(INNER_TYPES) / sizeof(INNER_TYPES[0]))];
+    uint32_t kind = tx_random(generator, 20);
+
+    if (generated == NULL) {
+        generated = &unused;
+    }
+    memset(generated, 0, sizeof(tx_generated_t));
+    if (kind < 14) {
+        generated->type = innerType;
+        generate_simple(generator, builder, innerType, networkType, generated);
+        generated->fee = generated->innerFee;
+        generated->innerFee = 0;
+        return;
+    }
+
+    random_header(generator, &header, 1, networkType);
+    uint32_t start;
+    if (kind < 17) {
+        generated->type = NEM_TXN_MULTISIG;
+        start = tx_begin_multisig(builder, &header);
+    } else {
+        generated->type = NEM_TXN_MULTISIG_SIGNATURE;
+        random_bytes(generator, hash, sizeof(hash));
+        random_address(generator, networkType, multisigAddress);
+        start = tx_begin_multisig_signature(builder, &header, hash, multisigAddress);
+    }
+    generated->fee = header.fee;
+    generated->innerType = innerType;
+    generate_simple(generator, builder, innerType, networkType, generated);
+    tx_end_struct(builder, start);
+}
@@ -0,0 +1,35 @@
+// Seeded generator of random valid NEM transactions on top of transaction_builder.h
+//
+// The same seed always gives the same sequence of transactions. Generated
+// transactions stay within the Nano S limits of limitations.h (field count
+// and raw transaction size), so they can be replayed on any target.
+#ifndef TESTS_BUILDER_TRANSACTION_GENERATOR_H
+#define TESTS_BUILDER_TRANSACTION_GENERATOR_H
+
+#include "transaction_builder.h"
+
+typedef struct tx_generator_t {
+    uint64_t state;
+} tx_generator_t;
+
+// What was generated, to check the parsed fields against
+typedef struct tx_generated_t {
+    uint32_t type;
+    // Wrapped transaction of multisig and multisig signatures, 0 otherwise
+    uint32_t innerType;
+    uint64_t fee;
+    uint64_t innerFee;
+    bool hasRecipient;
+    char recipient[NEM_ADDRESS_LENGTH];
+} tx_generated_t;
+
+void tx_generator_init(tx_generator_t *generator, uint64_t seed);
+
+// Uniform value in [0, bound), bound must not be 0
+uint32_t tx_random(tx_generator_t *generator, uint32_t bound);
+uint64_t tx_random_uint64(tx_generator_t *generator);
+
+// Write a random transaction in the builder, generated may be NULL
+void tx_generate(tx_generator_t *generator, tx_builder_t *builder, tx_generated_t *generated);
+
+#endif // TESTS_BUILDER_TRANSACTION_GENERATOR_H
@@ -0,0 +1,45 @@
+// Fuzz target: parse arbitrary bytes as a transaction and format every resulting field.
+//
+// Built with libFuzzer (clang -fsanitize=fuzzer) or with standalone_driver.c for AFL
+// and for replaying a corpus with any compiler.
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "parse/nem_parse.h"
+#include "format/format.h"
+#include "format/summary.h"
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+    parse_context_t context;
+    summary_t summary;
+    char fieldName[MAX_FIELDNAME_LEN];
+    char fieldValue[MAX_FIELD_LEN];
+
+    // Same limit as the APDU handler
+    if (size > MAX_RAW_TX) {
+        return 0;
+    }
+    // Exact size copy so the sanitizers catch any read past the transaction
+    uint8_t *buffer = malloc(size == 0 ? 1 : size);
+    if (buffer == NULL) {
+        return 0;
+    }
+    memcpy(buffer, data, size);
+
+    memset(&context, 0, sizeof(context));
+    context.data = buffer;
+    context.length = (uint32_t) size;
+    if (parse_txn_context(&context) == 0) {
+        for (uint8_t i = 0; i < context.result.numFields; i++) {
+            resolve_fieldname(&context.result.fields[i], fieldName);
+            format_field(&context.result, &context.result.fields[i], fieldValue);
+        }
+        if (build_summary(&context.result, &summary) == 0) {
+            for (uint8_t i = 0; i < summary.numPages; i++) {
+                format_summary_page(&summary, i, fieldName, fieldValue);
+            }
+        }
+    }
+    free(buffer);
+    return 0;
+}
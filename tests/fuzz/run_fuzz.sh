@@ -0,0 +1,57 @@
+#!/bin/bash
+# Builds the transaction parser fuzz target with libFuzzer, runs it on a copy of
+# tests/testcases and reports executions per second and line coverage.
+#
+# usage: run_fuzz.sh [seconds] [libFuzzer options...]
+# Requires clang, llvm-profdata and llvm-cov.
+set -e
+
+SECONDS_TO_RUN=${1:-60}
+shift || true
+
+CC=${CC:-clang}
+FUZZ_DIR=$(cd "$(dirname "$0")" && pwd)
+TESTS_DIR=$(dirname "$FUZZ_DIR")
+SRC_DIR=$(cd "$TESTS_DIR/../src" && pwd)
+WORK_DIR=${WORK_DIR:-$TESTS_DIR/fuzz_work}
+
+SOURCES="$FUZZ_DIR/fuzz_transaction_parser.c
+         $SRC_DIR/nem/nem_helpers.c
+         $SRC_DIR/nem/parse/nem_parse.c
+         $SRC_DIR/nem/format/fields.c
+         $SRC_DIR/nem/format/format.c
+         $SRC_DIR/nem/format/printers.c
+         $SRC_DIR/nem/format/readers.c
+         $SRC_DIR/nem/format/summary.c
+         $SRC_DIR/base32.c"
+CFLAGS="-g -O1 -DFUZZ -I$TESTS_DIR -I$SRC_DIR -I$SRC_DIR/nem"
+
+mkdir -p "$WORK_DIR/corpus" "$WORK_DIR/artifacts"
+cp -n "$TESTS_DIR"/testcases/*.raw "$WORK_DIR/corpus/" 2>/dev/null || true
+
+# Fuzzing build, with sanitizers
+$CC $CFLAGS -fsanitize=fuzzer,address,undefined -fno-sanitize-recover=undefined \
+    $SOURCES -o "$WORK_DIR/fuzz_transaction_parser"
+
+# Coverage build, replays the corpus without instrumentation of the sanitizers
+$CC $CFLAGS -fsanitize=fuzzer -fprofile-instr-generate -fcoverage-mapping \
+    $SOURCES -o "$WORK_DIR/fuzz_transaction_parser_cov"
+
+"$WORK_DIR/fuzz_transaction_parser" "$WORK_DIR/corpus" \
+    -dict="$FUZZ_DIR/nem.dict" \
+    -max_total_time="$SECONDS_TO_RUN" \
+    -max_len=10000 \
+    -artifact_prefix="$WORK_DIR/artifacts/" \
+    -print_final_stats=1 "$@" 2>&1 | tee "$WORK_DIR/fuzz.log"
+
+EXECS=$(grep -o 'stat::number_of_executed_units: *[0-9]*' "$WORK_DIR/fuzz.log" | grep -o '[0-9]*$')
+RATE=$(grep -o 'stat::average_exec_per_sec: *[0-9]*' "$WORK_DIR/fuzz.log" | grep -o '[0-9]*$')
+echo
+echo "Executions: ${EXECS:-unknown}, ${RATE:-unknown} execs/s"
+echo "Corpus: $(ls "$WORK_DIR/corpus" | wc -l) inputs, crashes: $(ls "$WORK_DIR/artifacts" | wc -l)"
+
+LLVM_PROFILE_FILE="$WORK_DIR/coverage.profraw" \
+    "$WORK_DIR/fuzz_transaction_parser_cov" -runs=0 "$WORK_DIR/corpus" > /dev/null 2>&1
+llvm-profdata merge -sparse "$WORK_DIR/coverage.profraw" -o "$WORK_DIR/coverage.profdata"
+llvm-cov report "$WORK_DIR/fuzz_transaction_parser_cov" -instr-profile="$WORK_DIR/coverage.profdata" \
+    "$SRC_DIR/nem"
@@ -0,0 +1,86 @@
+// Runs LLVMFuzzerTestOneInput() without libFuzzer.
+//
+// With arguments, every file (or every file of every directory) is run once and the
+// number of executions per second is reported. Without argument, the input is read
+// from stdin as expected by AFL, in persistent mode when built with afl-clang-fast.
+#include <dirent.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+
+#define MAX_INPUT_SIZE (1024 * 1024)
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size);
+
+static uint8_t input[MAX_INPUT_SIZE];
+static unsigned long executions;
+static unsigned long long elapsedNs;
+
+static unsigned long long now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long) ts.tv_sec * 1000000000ULL + (unsigned long long) ts.tv_nsec;
+}
+
+static void run_file(const char *filename) {
+    FILE *f = fopen(filename, "rb");
+    if (f == NULL) {
+        perror(filename);
+        exit(EXIT_FAILURE);
+    }
+    size_t size = fread(input, 1, sizeof(input), f);
+    fclose(f);
+
+    unsigned long long start = now_ns();
+    LLVMFuzzerTestOneInput(input, size);
+    elapsedNs += now_ns() - start;
+    executions++;
+}
+
+static void run_path(const char *path) {
+    struct stat st;
+    if (stat(path, &st) != 0) {
+        perror(path);
+        exit(EXIT_FAILURE);
+    }
+    if (!S_ISDIR(st.st_mode)) {
+        run_file(path);
+        return;
+    }
+    DIR *dir = opendir(path);
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL) {
+        char child[PATH_MAX];
+        if (entry->d_name[0] == '.') {
+            continue;
+        }
+        snprintf(child, sizeof(child), "%s/%s", path, entry->d_name);
+        run_path(child);
+    }
+    closedir(dir);
+}
+
+int main(int argc, char *argv[]) {
+    if (argc == 1) {
+#ifdef __AFL_LOOP
+        while (__AFL_LOOP(10000)) {
+#endif
+            size_t size = fread(input, 1, sizeof(input), stdin);
+            LLVMFuzzerTestOneInput(input, size);
+#ifdef __AFL_LOOP
+        }
+#endif
+        return EXIT_SUCCESS;
+    }
+
+    for (int i = 1; i < argc; i++) {
+        run_path(argv[i]);
+    }
+    printf("%lu inputs, %.0f execs/s\n", executions,
+           elapsedNs == 0 ? 0.0 : (double) executions * 1e9 / (double) elapsedNs);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,96 @@
+// Subset of the BOLOS cryptography API used by the application.
+// Keccak and SHA3 are real, the other primitives are deterministic fakes (see host_sdk.c).
+#ifndef HOST_SDK_CX_H
+#define HOST_SDK_CX_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define CX_LAST (1 << 0)
+#define CX_ENCRYPT (1 << 1)
+#define CX_DECRYPT (0 << 1)
+#define CX_CHAIN_CBC (1 << 3)
+#define CX_PAD_NONE 0
+
+typedef enum {
+    CX_NONE,
+    CX_RIPEMD160,
+    CX_SHA224,
+    CX_SHA256,
+    CX_SHA384,
+    CX_SHA512,
+    CX_KECCAK,
+    CX_SHA3,
+} cx_md_t;
+
+typedef enum {
+    CX_CURVE_NONE,
+    CX_CURVE_SECP256K1,
+    CX_CURVE_Ed25519,
+} cx_curve_t;
+
+typedef struct {
+    cx_md_t algo;
+} cx_hash_header_t;
+
+typedef cx_hash_header_t cx_hash_t;
+
+typedef struct {
+    cx_hash_header_t header;
+    unsigned int output_size;
+    unsigned int block_size;
+    unsigned int blen;
+    unsigned char block[200];
+    uint64_t acc[25];
+} cx_sha3_t;
+
+typedef struct {
+    cx_hash_header_t header;
+    cx_sha3_t inner;
+} cx_ripemd160_t;
+
+typedef struct {
+    cx_curve_t curve;
+    unsigned int d_len;
+    unsigned char d[32];
+} cx_ecfp_private_key_t;
+
+typedef struct {
+    cx_curve_t curve;
+    unsigned int W_len;
+    unsigned char W[65];
+} cx_ecfp_public_key_t;
+
+typedef struct {
+    unsigned char key[32];
+} cx_aes_key_t;
+
+int cx_keccak_init(cx_sha3_t *hash, unsigned int size);
+int cx_sha3_init(cx_sha3_t *hash, unsigned int size);
+int cx_ripemd160_init(cx_ripemd160_t *hash);
+int cx_hash(cx_hash_t *hash, int mode, const unsigned char *in, unsigned int len,
+            unsigned char *out, unsigned int out_len);
+unsigned char *cx_rng(unsigned char *buffer, unsigned int len);
+
+int cx_ecfp_init_private_key(cx_curve_t curve, const unsigned char *rawkey, unsigned int key_len,
+                             cx_ecfp_private_key_t *pvkey);
+int cx_ecfp_generate_pair2(cx_curve_t curve, cx_ecfp_public_key_t *pubkey,
+                           cx_ecfp_private_key_t *privkey, int keepprivate, cx_md_t hashID);
+int cx_eddsa_sign(const cx_ecfp_private_key_t *pvkey, int mode, cx_md_t hashID,
+                  const unsigned char *hash, unsigned int hash_len,
+                  const unsigned char *ctx, unsigned int ctx_len,
+                  unsigned char *sig, unsigned int sig_len, unsigned int *info);
+int cx_ecfp_init_public_key(cx_curve_t curve, const unsigned char *rawkey, unsigned int key_len,
+                            cx_ecfp_public_key_t *key);
+int cx_eddsa_verify(const cx_ecfp_public_key_t *pukey, int mode, cx_md_t hashID,
+                    const unsigned char *hash, unsigned int hash_len,
+                    const unsigned char *ctx, unsigned int ctx_len,
+                    const unsigned char *sig, unsigned int sig_len);
+int cx_hmac_sha512(const unsigned char *key, unsigned int key_len,
+                   const unsigned char *in, unsigned int len,
+                   unsigned char *mac, unsigned int mac_len);
+int cx_aes_init_key(const unsigned char *rawkey, unsigned int key_len, cx_aes_key_t *key);
+int cx_aes_iv(const cx_aes_key_t *key, int mode, const unsigned char *iv, unsigned int iv_len,
+              const unsigned char *in, unsigned int len, unsigned char *out, unsigned int out_len);
+
+#endif // HOST_SDK_CX_H
@@ -0,0 +1,25 @@
+// Icons generated from glyphs/ by the device build, only identified by name on the host
+#ifndef HOST_SDK_GLYPHS_H
+#define HOST_SDK_GLYPHS_H
+
+typedef struct {
+    const char *name;
+} bagl_icon_details_t;
+
+extern const bagl_icon_details_t C_icon_NEM;
+extern const bagl_icon_details_t C_icon_back;
+extern const bagl_icon_details_t C_icon_back_x;
+extern const bagl_icon_details_t C_icon_crossmark;
+extern const bagl_icon_details_t C_icon_dashboard;
+extern const bagl_icon_details_t C_icon_dashboard_x;
+extern const bagl_icon_details_t C_icon_eye;
+extern const bagl_icon_details_t C_icon_validate_14;
+extern const bagl_icon_details_t C_icon_warning;
+extern const bagl_icon_details_t C_icon_toggle_set;
+extern const bagl_icon_details_t C_icon_toggle_reset;
+extern const bagl_icon_details_t C_icon_left;
+extern const bagl_icon_details_t C_icon_right;
+extern const bagl_icon_details_t C_icon_up;
+extern const bagl_icon_details_t C_icon_down;
+
+#endif // HOST_SDK_GLYPHS_H
@@ -0,0 +1,370 @@
+// Host implementation of the BOLOS SDK subset declared in this directory.
+//
+// Exceptions, APDU transport, NVRAM and UX flows behave like on the device.
+// Keccak and SHA3 are real so hashes and checksums can be compared with the
+// NEM reference, but key derivation, Ed25519, RIPEMD160, HMAC and the random
+// generator are deterministic fakes built on Keccak: they exercise the command
+// layer, not the cryptography, and their outputs are not valid NEM keys or
+// signatures.
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "os.h"
+#include "ux.h"
+#include "glyphs.h"
+#include "host_sdk.h"
+
+unsigned char G_io_apdu_buffer[IO_APDU_BUFFER_SIZE];
+ux_state_t G_ux;
+
+unsigned char host_response[IO_APDU_BUFFER_SIZE];
+unsigned int host_response_length;
+bool host_response_sent;
+unsigned int host_heartbeats;
+
+const bagl_icon_details_t C_icon_NEM = {"NEM"};
+const bagl_icon_details_t C_icon_back = {"back"};
+const bagl_icon_details_t C_icon_back_x = {"back_x"};
+const bagl_icon_details_t C_icon_crossmark = {"crossmark"};
+const bagl_icon_details_t C_icon_dashboard = {"dashboard"};
+const bagl_icon_details_t C_icon_dashboard_x = {"dashboard_x"};
+const bagl_icon_details_t C_icon_eye = {"eye"};
+const bagl_icon_details_t C_icon_validate_14 = {"validate_14"};
+const bagl_icon_details_t C_icon_warning = {"warning"};
+const bagl_icon_details_t C_icon_toggle_set = {"toggle_set"};
+const bagl_icon_details_t C_icon_toggle_reset = {"toggle_reset"};
+const bagl_icon_details_t C_icon_left = {"left"};
+const bagl_icon_details_t C_icon_right = {"right"};
+const bagl_icon_details_t C_icon_up = {"up"};
+const bagl_icon_details_t C_icon_down = {"down"};
+
+// Exceptions
+
+static try_context_t *current_try_context;
+
+try_context_t *try_context_get(void) {
+    return current_try_context;
+}
+
+try_context_t *try_context_set(try_context_t *context) {
+    try_context_t *previous = current_try_context;
+    current_try_context = context;
+    return previous;
+}
+
+void os_longjmp(unsigned int exception) {
+    if (current_try_context == NULL) {
+        fprintf(stderr, "uncaught exception 0x%04x\n", exception);
+        abort();
+    }
+    longjmp(current_try_context->jmp_buf, exception);
+}
+
+// APDU transport
+
+void host_clear_response(void) {
+    host_response_length = 0;
+    host_response_sent = false;
+}
+
+unsigned short io_exchange(unsigned char channel_and_flags, unsigned short tx_len) {
+    if (channel_and_flags & IO_RETURN_AFTER_TX) {
+        memcpy(host_response, G_io_apdu_buffer, tx_len);
+        host_response_length = tx_len;
+        host_response_sent = true;
+    }
+    return 0;
+}
+
+void io_seproxyhal_io_heartbeat(void) {
+    host_heartbeats++;
+}
+
+void os_sched_exit(int exit_code) {
+    exit(exit_code);
+}
+
+uint32_t host_perf_ticks(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t) ((uint64_t) ts.tv_sec * 1000000u + (uint64_t) ts.tv_nsec / 1000u);
+}
+
+// Non volatile memory: const N_ variables may be placed in read-only pages by the host linker,
+// make them writable the first time they are written
+
+void nvm_write(void *dst_adr, void *src_adr, unsigned int src_len) {
+    uintptr_t page_size = (uintptr_t) sysconf(_SC_PAGESIZE);
+    uintptr_t start = (uintptr_t) dst_adr & ~(page_size - 1);
+    uintptr_t end = (uintptr_t) dst_adr + src_len;
+    if (mprotect((void *) start, end - start, PROT_READ | PROT_WRITE) != 0) {
+        perror("nvm_write");
+        abort();
+    }
+    if (src_adr == NULL) {
+        memset(dst_adr, 0, src_len);
+    } else {
+        memmove(dst_adr, src_adr, src_len);
+    }
+}
+
+// Keccak-f[1600], FIPS 202
+
+static const uint64_t keccak_round_constants[24] = {
+    0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808aULL, 0x8000000080008000ULL,
+    0x000000000000808bULL, 0x0000000080000001ULL, 0x8000000080008081ULL, 0x8000000000008009ULL,
+    0x000000000000008aULL, 0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000aULL,
+    0x000000008000808bULL, 0x800000000000008bULL, 0x8000000000008089ULL, 0x8000000000008003ULL,
+    0x8000000000008002ULL, 0x8000000000000080ULL, 0x000000000000800aULL, 0x800000008000000aULL,
+    0x8000000080008081ULL, 0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL
+};
+static const unsigned int keccak_rotations[24] = {
+    1, 3, 6, 10, 15, 21, 28, 36, 45, 55, 2, 14, 27, 41, 56, 8, 25, 43, 62, 18, 39, 61, 20, 44
+};
+static const unsigned int keccak_lanes[24] = {
+    10, 7, 11, 17, 18, 3, 5, 16, 8, 21, 24, 4, 15, 23, 19, 13, 12, 2, 20, 14, 22, 9, 6, 1
+};
+
+#define ROTL64(x, n) (((x) << (n)) | ((x) >> (64 - (n))))
+
+static void keccak_f(uint64_t state[25]) {
+    uint64_t lanes[5];
+    uint64_t t;
+    for (int round = 0; round < 24; round++) {
+        // theta
+        for (int i = 0; i < 5; i++) {
+            lanes[i] = state[i] ^ state[i + 5] ^ state[i + 10] ^ state[i + 15] ^ state[i + 20];
+        }
+        for (int i = 0; i < 5; i++) {
+            t = lanes[(i + 4) % 5] ^ ROTL64(lanes[(i + 1) % 5], 1);
+            for (int j = 0; j < 25; j += 5) {
+                state[j + i] ^= t;
+            }
+        }
+        // rho and pi
+        t = state[1];
+        for (int i = 0; i < 24; i++) {
+            uint64_t next = state[keccak_lanes[i]];
+            state[keccak_lanes[i]] = ROTL64(t, keccak_rotations[i]);
+            t = next;
+        }
+        // chi
+        for (int j = 0; j < 25; j += 5) {
+            for (int i = 0; i < 5; i++) {
+                lanes[i] = state[j + i];
+            }
+            for (int i = 0; i < 5; i++) {
+                state[j + i] ^= (~lanes[(i + 1) % 5]) & lanes[(i + 2) % 5];
+            }
+        }
+        // iota
+        state[0] ^= keccak_round_constants[round];
+    }
+}
+
+static int sha3_init(cx_sha3_t *hash, cx_md_t algo, unsigned int size) {
+    memset(hash, 0, sizeof(cx_sha3_t));
+    hash->header.algo = algo;
+    hash->output_size = size / 8;
+    hash->block_size = 200 - 2 * hash->output_size;
+    return 0;
+}
+
+static void sha3_absorb(cx_sha3_t *hash, unsigned char byte) {
+    hash->acc[hash->blen / 8] ^= (uint64_t) byte << (8 * (hash->blen % 8));
+    if (++hash->blen == hash->block_size) {
+        keccak_f(hash->acc);
+        hash->blen = 0;
+    }
+}
+
+static void sha3_update(cx_sha3_t *hash, const unsigned char *in, unsigned int len) {
+    for (unsigned int i = 0; i < len; i++) {
+        sha3_absorb(hash, in[i]);
+    }
+}
+
+static unsigned int sha3_final(cx_sha3_t *hash, unsigned char *out, unsigned int out_len) {
+    // Original Keccak and FIPS 202 only differ by the domain separation bits
+    hash->acc[hash->blen / 8] ^= (uint64_t) (hash->header.algo == CX_KECCAK ? 0x01 : 0x06) << (8 * (hash->blen % 8));
+    hash->acc[(hash->block_size - 1) / 8] ^= (uint64_t) 0x80 << (8 * ((hash->block_size - 1) % 8));
+    keccak_f(hash->acc);
+    unsigned int len = MIN(out_len, hash->output_size);
+    for (unsigned int i = 0; i < len; i++) {
+        out[i] = (unsigned char) (hash->acc[i / 8] >> (8 * (i % 8)));
+    }
+    return len;
+}
+
+int cx_keccak_init(cx_sha3_t *hash, unsigned int size) {
+    return sha3_init(hash, CX_KECCAK, size);
+}
+
+int cx_sha3_init(cx_sha3_t *hash, unsigned int size) {
+    return sha3_init(hash, CX_SHA3, size);
+}
+
+// Fake: truncated Keccak-256
+int cx_ripemd160_init(cx_ripemd160_t *hash) {
+    hash->header.algo = CX_RIPEMD160;
+    return cx_keccak_init(&hash->inner, 256);
+}
+
+int cx_hash(cx_hash_t *hash, int mode, const unsigned char *in, unsigned int len,
+            unsigned char *out, unsigned int out_len) {
+    unsigned char digest[32];
+    cx_sha3_t *sha3 = hash->algo == CX_RIPEMD160 ? &((cx_ripemd160_t *) hash)->inner : (cx_sha3_t *) hash;
+    sha3_update(sha3, in, len);
+    if (!(mode & CX_LAST)) {
+        return 0;
+    }
+    unsigned int digest_len = sha3_final(sha3, digest, sizeof(digest));
+    if (hash->algo == CX_RIPEMD160) {
+        digest_len = 20;
+    }
+    digest_len = MIN(digest_len, out_len);
+    memcpy(out, digest, digest_len);
+    return (int) digest_len;
+}
+
+static void keccak256(const unsigned char *in1, unsigned int len1, const unsigned char *in2, unsigned int len2,
+                      unsigned char *out) {
+    cx_sha3_t hash;
+    cx_keccak_init(&hash, 256);
+    cx_hash(&hash.header, 0, in1, len1, NULL, 0);
+    cx_hash(&hash.header, CX_LAST, in2, len2, out, 32);
+}
+
+// Fake random generator: Keccak-256 chain
+
+unsigned char *cx_rng(unsigned char *buffer, unsigned int len) {
+    static unsigned char state[32];
+    for (unsigned int i = 0; i < len; i += sizeof(state)) {
+        keccak256(state, sizeof(state), NULL, 0, state);
+        memcpy(buffer + i, state, MIN(sizeof(state), len - i));
+    }
+    return buffer;
+}
+
+// Fake key derivation: Keccak-256 of the path and the seed key
+
+void os_perso_derive_node_bip32_seed_key(unsigned int mode, unsigned int curve,
+                                         const unsigned int *path, unsigned int pathLength,
+                                         unsigned char *privateKey, unsigned char *chain,
+                                         unsigned char *seed_key, unsigned int seed_key_length) {
+    UNUSED(mode);
+    UNUSED(curve);
+    keccak256((const unsigned char *) path, pathLength * sizeof(unsigned int), seed_key, seed_key_length, privateKey);
+    if (chain != NULL) {
+        keccak256(privateKey, 32, NULL, 0, chain);
+    }
+}
+
+// Fake Ed25519: the public key and the signature are Keccak-256 chains of the private key
+
+int cx_ecfp_init_private_key(cx_curve_t curve, const unsigned char *rawkey, unsigned int key_len,
+                             cx_ecfp_private_key_t *pvkey) {
+    pvkey->curve = curve;
+    pvkey->d_len = MIN(key_len, sizeof(pvkey->d));
+    memcpy(pvkey->d, rawkey, pvkey->d_len);
+    return (int) pvkey->d_len;
+}
+
+int cx_ecfp_generate_pair2(cx_curve_t curve, cx_ecfp_public_key_t *pubkey,
+                           cx_ecfp_private_key_t *privkey, int keepprivate, cx_md_t hashID) {
+    UNUSED(keepprivate);
+    UNUSED(hashID);
+    pubkey->curve = curve;
+    pubkey->W_len = 65;
+    pubkey->W[0] = 0x04;
+    keccak256(privkey->d, privkey->d_len, NULL, 0, pubkey->W + 1);
+    keccak256(pubkey->W + 1, 32, NULL, 0, pubkey->W + 33);
+    return 0;
+}
+
+int cx_eddsa_sign(const cx_ecfp_private_key_t *pvkey, int mode, cx_md_t hashID,
+                  const unsigned char *hash, unsigned int hash_len,
+                  const unsigned char *ctx, unsigned int ctx_len,
+                  unsigned char *sig, unsigned int sig_len, unsigned int *info) {
+    UNUSED(mode);
+    UNUSED(hashID);
+    UNUSED(ctx);
+    UNUSED(ctx_len);
+    UNUSED(info);
+    if (sig_len < 64) {
+        THROW(INVALID_PARAMETER);
+    }
+    keccak256(pvkey->d, pvkey->d_len, hash, hash_len, sig);
+    keccak256(sig, 32, hash, hash_len, sig + 32);
+    return 64;
+}
+
+int cx_ecfp_init_public_key(cx_curve_t curve, const unsigned char *rawkey, unsigned int key_len,
+                            cx_ecfp_public_key_t *key) {
+    key->curve = curve;
+    key->W_len = MIN(key_len, sizeof(key->W));
+    memcpy(key->W, rawkey, key->W_len);
+    return (int) key->W_len;
+}
+
+// Accepts the fake signature made with the X coordinate of the public key as private key
+int cx_eddsa_verify(const cx_ecfp_public_key_t *pukey, int mode, cx_md_t hashID,
+                    const unsigned char *hash, unsigned int hash_len,
+                    const unsigned char *ctx, unsigned int ctx_len,
+                    const unsigned char *sig, unsigned int sig_len) {
+    cx_ecfp_private_key_t key;
+    unsigned char expected[64];
+    if (pukey->W_len != 65 || sig_len != sizeof(expected)) {
+        return 0;
+    }
+    cx_ecfp_init_private_key(pukey->curve, pukey->W + 1, 32, &key);
+    cx_eddsa_sign(&key, mode, hashID, hash, hash_len, ctx, ctx_len, expected, sizeof(expected), NULL);
+    return memcmp(expected, sig, sizeof(expected)) == 0;
+}
+
+int cx_hmac_sha512(const unsigned char *key, unsigned int key_len,
+                   const unsigned char *in, unsigned int len,
+                   unsigned char *mac, unsigned int mac_len) {
+    unsigned char digest[64];
+    keccak256(key, key_len, in, len, digest);
+    keccak256(digest, 32, NULL, 0, digest + 32);
+    mac_len = MIN(mac_len, sizeof(digest));
+    memcpy(mac, digest, mac_len);
+    return (int) mac_len;
+}
+
+// UX flows: the current step is initialized like the device does when it is displayed
+
+void ux_flow_init(unsigned int stack_slot, const ux_flow_step_t *const *steps,
+                  const ux_flow_step_t *const start_step) {
+    ux_flow_state_t *flow = &G_ux.flow_stack[stack_slot];
+    flow->steps = steps;
+    flow->index = 0;
+    flow->length = 0;
+    while (steps[flow->length] != FLOW_END_STEP) {
+        if (steps[flow->length] == start_step) {
+            flow->index = flow->length;
+        }
+        flow->length++;
+    }
+    if (flow->length > 0 && steps[flow->index]->init != NULL) {
+        steps[flow->index]->init(stack_slot);
+    }
+}
+
+void ux_flow_relayout(void) {
+    unsigned int stack_slot = G_ux.stack_count == 0 ? 0 : G_ux.stack_count - 1;
+    ux_flow_state_t *flow = &G_ux.flow_stack[stack_slot];
+    if (flow->length > 0 && flow->steps[flow->index]->init != NULL) {
+        flow->steps[flow->index]->init(stack_slot);
+    }
+}
+
+unsigned int ux_stack_push(void) {
+    if (G_ux.stack_count < UX_STACK_SLOT_COUNT) {
+        G_ux.stack_count++;
+    }
+    return G_ux.stack_count - 1;
+}
@@ -0,0 +1,21 @@
+// Hooks of the host SDK used by the simulator to observe the application
+#ifndef HOST_SDK_HOST_SDK_H
+#define HOST_SDK_HOST_SDK_H
+
+#include <stdint.h>
+#include "os.h"
+
+// Last response sent back with io_exchange(CHANNEL_APDU | IO_RETURN_AFTER_TX, ...)
+extern unsigned char host_response[IO_APDU_BUFFER_SIZE];
+extern unsigned int host_response_length;
+extern bool host_response_sent;
+
+// Number of io_seproxyhal_io_heartbeat() calls, a rough measure of the slow operations
+extern unsigned int host_heartbeats;
+
+void host_clear_response(void);
+
+// Microseconds of the monotonic clock, PERF_TICK_FUNCTION of the simulator (see perf.h)
+uint32_t host_perf_ticks(void);
+
+#endif // HOST_SDK_HOST_SDK_H
@@ -0,0 +1,119 @@
+// Subset of the BOLOS SDK used by the application, implemented on the host in host_sdk.c
+#ifndef HOST_SDK_OS_H
+#define HOST_SDK_OS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <setjmp.h>
+#include "bolos_target.h"
+
+#ifndef UNUSED
+#define UNUSED(x) (void)(x)
+#endif
+#ifndef PRINTF
+#define PRINTF(...)
+#endif
+#ifndef MIN
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#endif
+#define PIC(x) (x)
+#define N_storage_real_section
+#define WIDE
+
+typedef unsigned short exception_t;
+
+typedef struct try_context_s {
+    jmp_buf jmp_buf;
+    struct try_context_s *previous;
+    exception_t ex;
+} try_context_t;
+
+try_context_t *try_context_get(void);
+try_context_t *try_context_set(try_context_t *context);
+
+#define BEGIN_TRY_L(L) { try_context_t __try##L;
+#define TRY_L(L) \
+    __try##L.ex = setjmp(__try##L.jmp_buf); \
+    if (__try##L.ex == 0) { \
+        __try##L.previous = try_context_set(&__try##L);
+#define CATCH_L(L, x) \
+        goto __FINALLY##L; \
+    } else if (__try##L.ex == (x)) { \
+        __try##L.ex = 0; \
+        CLOSE_TRY_L(L);
+#define CATCH_OTHER_L(L, e) \
+        goto __FINALLY##L; \
+    } else { \
+        exception_t e; \
+        e = __try##L.ex; \
+        (void) e; \
+        __try##L.ex = 0; \
+        CLOSE_TRY_L(L);
+#define CATCH_ALL_L(L) \
+        goto __FINALLY##L; \
+    } else { \
+        __try##L.ex = 0; \
+        CLOSE_TRY_L(L);
+#define FINALLY_L(L) \
+        goto __FINALLY##L; \
+    } \
+    __FINALLY##L: \
+    if (try_context_get() == &__try##L) { \
+        try_context_set(__try##L.previous); \
+    }
+#define END_TRY_L(L) \
+    if (__try##L.ex != 0) { \
+        THROW_L(L, __try##L.ex); \
+    } \
+    }
+#define CLOSE_TRY_L(L) try_context_set(__try##L.previous)
+#define THROW_L(L, x) os_longjmp(x)
+
+#define BEGIN_TRY BEGIN_TRY_L(_)
+#define TRY TRY_L(_)
+#define CATCH(x) CATCH_L(_, x)
+#define CATCH_OTHER(e) CATCH_OTHER_L(_, e)
+#define CATCH_ALL CATCH_ALL_L(_)
+#define FINALLY FINALLY_L(_)
+#define END_TRY END_TRY_L(_)
+#define CLOSE_TRY CLOSE_TRY_L(_)
+#define THROW(x) os_longjmp(x)
+
+void os_longjmp(unsigned int exception) __attribute__((noreturn));
+
+#define EXCEPTION 1
+#define INVALID_PARAMETER 2
+#define EXCEPTION_IO_RESET 0x10
+
+// APDU transport
+#define IO_APDU_BUFFER_SIZE (5 + 255)
+extern unsigned char G_io_apdu_buffer[IO_APDU_BUFFER_SIZE];
+
+#define CHANNEL_APDU 0
+#define CHANNEL_KEYBOARD 1
+#define CHANNEL_SPI 2
+#define IO_RESET_AFTER_REPLIED 0x80
+#define IO_RECEIVE_DATA 0x40
+#define IO_RETURN_AFTER_TX 0x20
+#define IO_ASYNCH_REPLY 0x10
+#define IO_FLAGS 0xF8
+
+unsigned short io_exchange(unsigned char channel_and_flags, unsigned short tx_len);
+void io_seproxyhal_io_heartbeat(void);
+void os_sched_exit(int exit_code);
+
+// Key derivation
+#define HDW_NORMAL 0
+#define HDW_ED25519_SLIP10 1
+void os_perso_derive_node_bip32_seed_key(unsigned int mode, unsigned int curve,
+                                         const unsigned int *path, unsigned int pathLength,
+                                         unsigned char *privateKey, unsigned char *chain,
+                                         unsigned char *seed_key, unsigned int seed_key_length);
+
+// Non volatile memory
+void nvm_write(void *dst_adr, void *src_adr, unsigned int src_len);
+
+#include "cx.h"
+
+#endif // HOST_SDK_OS_H
@@ -0,0 +1,6 @@
+#ifndef HOST_SDK_OS_IO_SEPROXYHAL_H
+#define HOST_SDK_OS_IO_SEPROXYHAL_H
+
+#include "os.h"
+
+#endif // HOST_SDK_OS_IO_SEPROXYHAL_H
@@ -0,0 +1,88 @@
+// UX flow macros of the BOLOS SDK. Steps keep their name, layout, callbacks and
+// parameters so a host can walk through a flow like a user would.
+#ifndef HOST_SDK_UX_H
+#define HOST_SDK_UX_H
+
+#include <stdint.h>
+#include "os.h"
+
+// Layouts are only identified by name on the host
+typedef enum {
+    UX_LAYOUT_pb,
+    UX_LAYOUT_pn,
+    UX_LAYOUT_pnn,
+    UX_LAYOUT_bn,
+    UX_LAYOUT_nn,
+    UX_LAYOUT_bnnn_paging,
+} ux_layout_t;
+
+typedef struct ux_flow_step_s {
+    const char *name;
+    ux_layout_t layout;
+    void (*init)(unsigned int stack_slot);
+    void (*validate)(void);
+    const void *const *params;
+    unsigned int params_count;
+} ux_flow_step_t;
+
+typedef const ux_flow_step_t *const *ux_flow_t;
+
+#define FLOW_END_STEP ((const ux_flow_step_t *) 0xFFFFFFFFUL)
+#define FLOW_BARRIER ((const ux_flow_step_t *) 0xFFFFFFFEUL)
+#define FLOW_LOOP ((const ux_flow_step_t *) 0xFFFFFFFDUL)
+
+#define UX_STACK_SLOT_COUNT 4
+
+typedef struct {
+    const ux_flow_step_t *const *steps;
+    unsigned short index;
+    unsigned short length;
+} ux_flow_state_t;
+
+typedef struct {
+    unsigned char stack_count;
+    ux_flow_state_t flow_stack[UX_STACK_SLOT_COUNT];
+} ux_state_t;
+
+extern ux_state_t G_ux;
+
+#define UX_STEP_PARAMS(stepname, ...) \
+    static const void *const stepname##_params[] = __VA_ARGS__;
+
+#define UX_STEP_NOCB_INIT(stepname, layoutkind, preinit, ...) \
+    static void stepname##_init(unsigned int stack_slot) { UNUSED(stack_slot); preinit; } \
+    static const void *const stepname##_params[] = __VA_ARGS__; \
+    const ux_flow_step_t stepname = { #stepname, UX_LAYOUT_##layoutkind, stepname##_init, NULL, \
+        stepname##_params, sizeof(stepname##_params) / sizeof(stepname##_params[0]) }
+
+#define UX_STEP_NOCB(stepname, layoutkind, ...) \
+    static const void *const stepname##_params[] = __VA_ARGS__; \
+    const ux_flow_step_t stepname = { #stepname, UX_LAYOUT_##layoutkind, NULL, NULL, \
+        stepname##_params, sizeof(stepname##_params) / sizeof(stepname##_params[0]) }
+
+#define UX_STEP_CB_INIT(stepname, layoutkind, preinit, validate_cb, ...) \
+    static void stepname##_init(unsigned int stack_slot) { UNUSED(stack_slot); preinit; } \
+    static void stepname##_validate(void) { validate_cb; } \
+    static const void *const stepname##_params[] = __VA_ARGS__; \
+    const ux_flow_step_t stepname = { #stepname, UX_LAYOUT_##layoutkind, stepname##_init, \
+        stepname##_validate, stepname##_params, sizeof(stepname##_params) / sizeof(stepname##_params[0]) }
+
+#define UX_STEP_CB(stepname, layoutkind, validate_cb, ...) \
+    static void stepname##_validate(void) { validate_cb; } \
+    static const void *const stepname##_params[] = __VA_ARGS__; \
+    const ux_flow_step_t stepname = { #stepname, UX_LAYOUT_##layoutkind, NULL, stepname##_validate, \
+        stepname##_params, sizeof(stepname##_params) / sizeof(stepname##_params[0]) }
+
+#define UX_STEP_VALID UX_STEP_CB
+
+#define UX_FLOW(flowname, ...) \
+    const ux_flow_step_t *const flowname[] = { __VA_ARGS__, FLOW_END_STEP }
+
+void ux_flow_init(unsigned int stack_slot, const ux_flow_step_t *const *steps,
+                  const ux_flow_step_t *const start_step);
+void ux_flow_relayout(void);
+unsigned int ux_stack_push(void);
+
+#define UX_INIT()
+
+#endif // HOST_SDK_UX_H
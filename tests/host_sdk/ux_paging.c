@@ -0,0 +1,64 @@
+#include "ux_paging.h"
+
+// Advance width of the printable ASCII characters (0x20 to 0x7E) in
+// BAGL_FONT_OPEN_SANS_REGULAR_11px. The table is not shipped with the host SDK,
+// these widths approximate it: regenerate them from the font file of the SDK
+// for pixel exact line breaks.
+static const uint8_t CHAR_WIDTHS[95] = {
+    // space ! " # $ % & ' ( ) * + , - . /
+    3, 2, 4, 7, 6, 9, 8, 2, 3, 3, 6, 6, 3, 4, 2, 4,
+    // 0 to 9
+    6, 6, 6, 6, 6, 6, 6, 6, 6, 6,
+    // : ; < = > ? @
+    2, 3, 6, 6, 6, 5, 10,
+    // A to Z
+    7, 7, 7, 8, 6, 6, 8, 8, 3, 3, 7, 6, 10, 8, 9, 7, 9, 7, 6, 6, 8, 7, 10, 7, 6, 6,
+    // [ \ ] ^ _ `
+    3, 4, 3, 6, 5, 6,
+    // a to z
+    6, 7, 5, 7, 6, 4, 6, 7, 3, 3, 6, 3, 10, 7, 7, 7, 7, 5, 5, 4, 7, 6, 9, 6, 6, 5,
+    // { | } ~
+    4, 6, 4, 6
+};
+
+// Characters missing from the font are displayed with the width of a digit
+#define DEFAULT_CHAR_WIDTH 6
+
+unsigned int ux_paging_char_width(char c) {
+    if (c < 0x20 || c > 0x7E) {
+        return DEFAULT_CHAR_WIDTH;
+    }
+    return CHAR_WIDTHS[c - 0x20];
+}
+
+unsigned int ux_paging_split(const char *text, ux_paging_line_t *lines, unsigned int maxLines) {
+    unsigned int count = 0;
+    unsigned int offset = 0;
+    do {
+        unsigned int length = 0;
+        unsigned int width = 0;
+        while (text[offset + length] != '\0' && text[offset + length] != '\n') {
+            unsigned int charWidth = ux_paging_char_width(text[offset + length]);
+            if (width + charWidth > UX_PAGING_PIXELS_PER_LINE) {
+                break;
+            }
+            width += charWidth;
+            length++;
+        }
+        if (count < maxLines) {
+            lines[count].offset = offset;
+            lines[count].length = length;
+        }
+        count++;
+        offset += length;
+        if (text[offset] == '\n') {
+            offset++;
+        }
+    } while (text[offset] != '\0');
+    return count;
+}
+
+unsigned int ux_paging_page_count(const char *text) {
+    unsigned int lines = ux_paging_split(text, NULL, 0);
+    return (lines + UX_PAGING_LINE_COUNT - 1) / UX_PAGING_LINE_COUNT;
+}
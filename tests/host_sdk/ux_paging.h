@@ -0,0 +1,33 @@
+// Line splitting of the bnnn_paging layout, as done by ux_layout_paging_compute()
+// of the SDK: text is cut when the next character does not fit in the line or
+// on '\n', lines are grouped by pages of UX_PAGING_LINE_COUNT.
+#ifndef HOST_SDK_UX_PAGING_H
+#define HOST_SDK_UX_PAGING_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(TARGET_NANOS)
+// Bold title and one line of text on the 128x32 screen
+#define UX_PAGING_LINE_COUNT 1
+#else
+// Bold title and three lines of text on the 128x64 screen
+#define UX_PAGING_LINE_COUNT 3
+#endif
+#define UX_PAGING_PIXELS_PER_LINE 114
+
+typedef struct ux_paging_line_t {
+    unsigned int offset;
+    unsigned int length;
+} ux_paging_line_t;
+
+// Width of a character in the regular 11px font of the text lines
+unsigned int ux_paging_char_width(char c);
+
+// Split text in at most maxLines lines, returns the number of lines of the whole text
+unsigned int ux_paging_split(const char *text, ux_paging_line_t *lines, unsigned int maxLines);
+
+// Number of pages displayed for the text (at least 1)
+unsigned int ux_paging_page_count(const char *text);
+
+#endif // HOST_SDK_UX_PAGING_H
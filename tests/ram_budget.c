@@ -0,0 +1,15 @@
+// Checks the RAM taken by the state of pulled messages (see sign_transaction.h)
+// against PULL_CONTEXT_RAM_BUDGET of the target. Host pointers are larger than
+// on the device, so the host size is an upper bound of the device one.
+#include <stdio.h>
+#include <stdlib.h>
+#include "apdu/messages/sign_transaction.h"
+
+int main(void) {
+    printf("pull_context_t: %zu bytes, budget %d\n", sizeof(pull_context_t), PULL_CONTEXT_RAM_BUDGET);
+    if (sizeof(pull_context_t) > PULL_CONTEXT_RAM_BUDGET) {
+        fprintf(stderr, "pull_context_t exceeds PULL_CONTEXT_RAM_BUDGET, see limitations.h\n");
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
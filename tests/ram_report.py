@@ -0,0 +1,50 @@
+#!/usr/bin/env python3
+# RAM used by every global of the application, per target
+#
+# The size of the .bss and .data symbols of each ELF file (e.g. bin/app.elf built
+# for each TARGET_NAME) is read with nm and reported side by side, largest first.
+# Symbols of the SDK are reported too, the NVRAM (N_storage) is not in RAM.
+import argparse
+import os
+import subprocess
+import sys
+
+RAM_TYPES = "bBdD"
+
+
+def read_symbols(nm, elf):
+    output = subprocess.run([nm, "-S", "-t", "d", elf], check=True, capture_output=True, text=True).stdout
+    symbols = {}
+    for line in output.splitlines():
+        parts = line.split()
+        # address size type name
+        if len(parts) == 4 and parts[2] in RAM_TYPES:
+            symbols[parts[3]] = symbols.get(parts[3], 0) + int(parts[1])
+    return symbols
+
+
+def main():
+    parser = argparse.ArgumentParser(description="RAM used by every global, per target")
+    parser.add_argument("--nm", default="nm", help="nm of the toolchain, e.g. arm-none-eabi-nm")
+    parser.add_argument("--min", type=int, default=0, help="hide the symbols smaller than this size in every file")
+    parser.add_argument("elf", nargs="+", help="ELF files, one per target")
+    args = parser.parse_args()
+
+    targets = [read_symbols(args.nm, elf) for elf in args.elf]
+    names = sorted(set().union(*targets), key=lambda name: (-max(t.get(name, 0) for t in targets), name))
+    labels = [os.path.basename(os.path.dirname(os.path.abspath(elf))) + "/" + os.path.basename(elf)
+              for elf in args.elf]
+    width = max(12, *(len(label) for label in labels))
+
+    print("%-40s" % "symbol" + "".join(" %*s" % (width, label) for label in labels))
+    for name in names:
+        sizes = [t.get(name) for t in targets]
+        if max(size or 0 for size in sizes) < args.min:
+            continue
+        print("%-40s" % name + "".join(" %*s" % (width, "-" if size is None else size) for size in sizes))
+    print("%-40s" % "total" + "".join(" %*d" % (width, sum(t.values())) for t in targets))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
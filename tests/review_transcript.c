@@ -0,0 +1,323 @@
+// Renders the screens displayed by display_review_menu() for raw transactions,
+// page by page, with the bnnn_paging line splitting of the target.
+//
+// Both the field by field review and the summary review are rendered. With -g,
+// transcripts are compared with the golden files of a directory (or written
+// there with -u). With -c, the number of pages of each review is reported per
+// transaction and per transaction type.
+#include <dirent.h>
+#include <limits.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <ux.h>
+#include "host_sdk.h"
+#include "ux_paging.h"
+#include "parse/nem_parse.h"
+#include "format/format.h"
+#include "format/printers.h"
+#include "storage/storage.h"
+#include "ui/transaction/review_menu.h"
+
+#define MAX_TRANSCRIPT_LEN 65536
+#define MAX_TYPE_LEN 64
+#define MAX_TYPES 32
+
+typedef struct {
+    char *data;
+    size_t length;
+} transcript_t;
+
+typedef struct {
+    char type[MAX_TYPE_LEN];
+    unsigned int count;
+    unsigned long reviewPages;
+    unsigned long summaryPages;
+} type_stats_t;
+
+static type_stats_t typeStats[MAX_TYPES];
+static unsigned int numTypes;
+
+static void append(transcript_t *transcript, const char *format, ...) __attribute__((format(printf, 2, 3)));
+
+static void append(transcript_t *transcript, const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    int len = vsnprintf(transcript->data + transcript->length, MAX_TRANSCRIPT_LEN - transcript->length, format, args);
+    va_end(args);
+    if (len > 0) {
+        transcript->length += (size_t) len;
+    }
+    if (transcript->length >= MAX_TRANSCRIPT_LEN) {
+        fprintf(stderr, "transcript too long\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+static void approval_callback(unsigned int result) {
+    UNUSED(result);
+}
+
+// Render the flow displayed in slot 0, returns the number of pages
+static unsigned int render_flow(transcript_t *transcript) {
+    ux_flow_state_t *flow = &G_ux.flow_stack[0];
+    ux_paging_line_t lines[MAX_FIELD_LEN + 1];
+    unsigned int pages = 0;
+
+    for (unsigned short i = 0; i < flow->length; i++) {
+        const ux_flow_step_t *step = flow->steps[i];
+        flow->index = i;
+        if (step->init != NULL) {
+            step->init(0);
+        }
+        if (step->layout != UX_LAYOUT_bnnn_paging) {
+            // Icon and lines, e.g. "[Recipient | Payroll]" for a recipient of the address book
+            append(transcript, "[");
+            for (unsigned int j = 1; j < step->params_count; j++) {
+                append(transcript, "%s%s", j == 1 ? "" : " | ", (const char *) step->params[j]);
+            }
+            append(transcript, "]\n");
+            pages++;
+            continue;
+        }
+        const char *title = step->params[0];
+        const char *text = step->params[1];
+        unsigned int numLines = ux_paging_split(text, lines, sizeof(lines) / sizeof(lines[0]));
+        unsigned int numPages = (numLines + UX_PAGING_LINE_COUNT - 1) / UX_PAGING_LINE_COUNT;
+        for (unsigned int page = 0; page < numPages; page++) {
+            if (numPages > 1) {
+                append(transcript, "%s (%u/%u)\n", title, page + 1, numPages);
+            } else {
+                append(transcript, "%s\n", title);
+            }
+            for (unsigned int j = page * UX_PAGING_LINE_COUNT; j < numLines && j < (page + 1) * UX_PAGING_LINE_COUNT; j++) {
+                append(transcript, "    %.*s\n", (int) lines[j].length, text + lines[j].offset);
+            }
+        }
+        pages += numPages;
+    }
+    return pages;
+}
+
+// Display the review with or without summary, returns false if the summary is not available
+static bool display_review(result_t *result, bool summaryReview) {
+    settings_t settings;
+    memcpy(&settings, (const void *) &N_storage.settings, sizeof(settings_t));
+    settings.summaryReview = summaryReview;
+    write_settings(&settings);
+    memset(&G_ux, 0, sizeof(G_ux));
+    display_review_menu(result, approval_callback);
+    return !summaryReview || strcmp(G_ux.flow_stack[0].steps[0]->name, "ux_summary_flow_step") == 0;
+}
+
+// e.g. "Multisig TX / Transfer TX"
+static void describe_transaction(const result_t *result, char *type) {
+    char value[MAX_FIELD_LEN];
+    size_t pos = 0;
+    type[0] = '\0';
+    for (uint8_t i = 0; i < result->numFields && pos < MAX_TYPE_LEN; i++) {
+        const field_t *field = &result->fields[i];
+        if (field->id == NEM_UINT32_TRANSACTION_TYPE || field->id == NEM_UINT32_INNER_TRANSACTION_TYPE ||
+            field->id == NEM_UINT32_DETAIL_TRANSACTION_TYPE) {
+            format_field(result, field, value);
+            pos += snprintf(type + pos, MAX_TYPE_LEN - pos, "%s%s", pos == 0 ? "" : " / ", value);
+        }
+    }
+}
+
+static void update_type_stats(const char *type, unsigned int reviewPages, unsigned int summaryPages) {
+    unsigned int i;
+    for (i = 0; i < numTypes && strcmp(typeStats[i].type, type) != 0; i++) {
+    }
+    if (i == numTypes) {
+        if (numTypes == MAX_TYPES) {
+            return;
+        }
+        snprintf(typeStats[numTypes++].type, MAX_TYPE_LEN, "%s", type);
+    }
+    typeStats[i].count++;
+    typeStats[i].reviewPages += reviewPages;
+    typeStats[i].summaryPages += summaryPages;
+}
+
+static uint8_t *load_file(const char *filename, size_t *size) {
+    FILE *f = fopen(filename, "rb");
+    if (f == NULL) {
+        perror(filename);
+        exit(EXIT_FAILURE);
+    }
+    fseek(f, 0, SEEK_END);
+    long filesize = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    uint8_t *data = malloc(filesize == 0 ? 1 : filesize);
+    if (data == NULL || fread(data, 1, filesize, f) != (size_t) filesize) {
+        fprintf(stderr, "%s: cannot read file\n", filename);
+        exit(EXIT_FAILURE);
+    }
+    fclose(f);
+    *size = (size_t) filesize;
+    return data;
+}
+
+// Render both reviews of a transaction, the page counts are only set if it can be parsed
+static void render_transaction(const char *filename, transcript_t *transcript, char *type,
+                               unsigned int *reviewPages, unsigned int *summaryPages) {
+    parse_context_t context;
+    size_t size;
+    uint8_t *data = load_file(filename, &size);
+
+    memset(&context, 0, sizeof(context));
+    context.data = data;
+    context.length = (uint32_t) size;
+    context.networkType = TESTNET;
+    *reviewPages = 0;
+    *summaryPages = 0;
+    type[0] = '\0';
+
+    int err = size > MAX_RAW_TX ? E_INVALID_DATA : parse_txn_context(&context);
+    if (err != E_SUCCESS) {
+        append(transcript, "Parsing error %d\n", err);
+    } else {
+        describe_transaction(&context.result, type);
+        append(transcript, "# Review\n");
+        display_review(&context.result, false);
+        *reviewPages = render_flow(transcript);
+        append(transcript, "# Summary\n");
+        if (display_review(&context.result, true)) {
+            *summaryPages = render_flow(transcript);
+        } else {
+            append(transcript, "Not available\n");
+        }
+        append(transcript, "# Pages: %u review, %u summary\n", *reviewPages, *summaryPages);
+    }
+    free(data);
+}
+
+// Returns false if the golden file differs
+static bool check_golden(const char *golden, const transcript_t *transcript, bool update) {
+    if (update) {
+        FILE *f = fopen(golden, "w");
+        if (f == NULL || fwrite(transcript->data, 1, transcript->length, f) != transcript->length) {
+            perror(golden);
+            exit(EXIT_FAILURE);
+        }
+        fclose(f);
+        return true;
+    }
+    size_t size;
+    char *expected = (char *) load_file(golden, &size);
+    bool same = size == transcript->length && memcmp(expected, transcript->data, size) == 0;
+    if (!same) {
+        // Report the first line that differs
+        size_t line = 1;
+        for (size_t i = 0; i < size && i < transcript->length && expected[i] == transcript->data[i]; i++) {
+            line += expected[i] == '\n';
+        }
+        fprintf(stderr, "%s:%zu: transcript differs\n", golden, line);
+    }
+    free(expected);
+    return same;
+}
+
+static int is_raw_file(const struct dirent *entry) {
+    size_t len = strlen(entry->d_name);
+    return len > 4 && strcmp(entry->d_name + len - 4, ".raw") == 0;
+}
+
+static const char *base_name(const char *path) {
+    const char *slash = strrchr(path, '/');
+    return slash == NULL ? path : slash + 1;
+}
+
+// Returns the number of golden files that differ
+static int process_file(const char *path, const char *goldenDir, bool update, bool countPages) {
+    transcript_t transcript = {malloc(MAX_TRANSCRIPT_LEN), 0};
+    char type[MAX_TYPE_LEN];
+    unsigned int reviewPages, summaryPages;
+    int failures = 0;
+
+    render_transaction(path, &transcript, type, &reviewPages, &summaryPages);
+    if (goldenDir != NULL) {
+        char golden[PATH_MAX];
+        const char *name = base_name(path);
+        snprintf(golden, sizeof(golden), "%s/%.*s.txt", goldenDir, (int) (strlen(name) - 4), name);
+        failures += !check_golden(golden, &transcript, update);
+    } else if (countPages) {
+        if (type[0] != '\0') {
+            printf("%-46s %-40s %8u %8u\n", base_name(path), type, reviewPages, summaryPages);
+            update_type_stats(type, reviewPages, summaryPages);
+        }
+    } else {
+        printf("## %s\n%.*s", base_name(path), (int) transcript.length, transcript.data);
+    }
+    free(transcript.data);
+    return failures;
+}
+
+static void usage(const char *name) {
+    fprintf(stderr, "usage: %s [-c] [-g golden directory [-u]] file or directory...\n"
+                    "  -c  report the number of pages per transaction and per type\n"
+                    "  -g  compare the transcripts with the golden files of the directory\n"
+                    "  -u  write the golden files instead of comparing them\n", name);
+    exit(EXIT_FAILURE);
+}
+
+int main(int argc, char *argv[]) {
+    const char *goldenDir = NULL;
+    bool update = false;
+    bool countPages = false;
+    int failures = 0;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "cg:u")) != -1) {
+        switch (opt) {
+            case 'c':
+                countPages = true;
+                break;
+            case 'g':
+                goldenDir = optarg;
+                break;
+            case 'u':
+                update = true;
+                break;
+            default:
+                usage(argv[0]);
+        }
+    }
+    if (optind >= argc || (update && goldenDir == NULL)) {
+        usage(argv[0]);
+    }
+    init_storage();
+    if (countPages) {
+        printf("%-46s %-40s %8s %8s\n", "file", "type", "review", "summary");
+    }
+
+    for (int i = optind; i < argc; i++) {
+        struct dirent **entries;
+        int count = scandir(argv[i], &entries, is_raw_file, alphasort);
+        if (count < 0) {
+            failures += process_file(argv[i], goldenDir, update, countPages);
+            continue;
+        }
+        for (int j = 0; j < count; j++) {
+            char path[PATH_MAX];
+            snprintf(path, sizeof(path), "%s/%s", argv[i], entries[j]->d_name);
+            failures += process_file(path, goldenDir, update, countPages);
+            free(entries[j]);
+        }
+        free(entries);
+    }
+
+    if (countPages) {
+        printf("\n%-40s %8s %14s %14s\n", "type", "count", "review pages", "summary pages");
+        for (unsigned int i = 0; i < numTypes; i++) {
+            const type_stats_t *s = &typeStats[i];
+            printf("%-40s %8u %14.1f %14.1f\n", s->type, s->count, (double) s->reviewPages / s->count,
+                   (double) s->summaryPages / s->count);
+        }
+    }
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -8,10 +8,12 @@
 
 #include "parse/nem_parse.h"
 #include "format/format.h"
-#include "apdu/global.h"  // FIXME: transaction_context_t should be defined elsewhere
-
-transaction_context_t transactionContext;
-
+#include "format/summary.h"
+#include "format/readers.h"
+#include "format/printers.h"
+#include "parse/cursor.h"
+#include "mosaics.h"
+#include "builder/transaction_generator.h"
 typedef struct {
     const char *field_name;
     const char *field_value;
@@ -53,7 +55,7 @@ static void check_transaction_results(const char *filename, int num_fields, cons
     for (int i = 0; i < context.result.numFields; i++) {
         const field_t *field = &context.result.fields[i];
         resolve_fieldname(field, field_name);
-        format_field(field, field_value);
+        format_field(&context.result, field, field_value);
         assert_string_equal(expected[i].field_name, field_name);
         assert_string_equal(expected[i].field_value, field_value);
     }
@@ -61,6 +63,48 @@ static void check_transaction_results(const char *filename, int num_fields, cons
     return;
 }
 
+static void check_transaction_summary(const char *filename, int num_pages, const result_entry_t *expected) {
+    parse_context_t context = {0};
+    summary_t summary;
+    char title[MAX_FIELDNAME_LEN];
+    char value[MAX_FIELD_LEN];
+
+    size_t tx_length;
+    uint8_t * const tx_data = load_transaction_data(filename, &tx_length);
+    assert_non_null(tx_data);
+
+    context.data = tx_data;
+    context.length = tx_length;
+
+    assert_int_equal(parse_txn_context(&context), 0);
+    assert_int_equal(build_summary(&context.result, &summary), 0);
+    assert_int_equal(summary.numPages, num_pages);
+
+    for (int i = 0; i < summary.numPages; i++) {
+        format_summary_page(&summary, i, title, value);
+        assert_string_equal(expected[i].field_name, title);
+        assert_string_equal(expected[i].field_value, value);
+    }
+    free(tx_data);
+}
+
+// Transactions with fields the summary cannot show are only reviewed field by field
+static void check_no_summary(const char *filename) {
+    parse_context_t context = {0};
+    summary_t summary;
+
+    size_t tx_length;
+    uint8_t * const tx_data = load_transaction_data(filename, &tx_length);
+    assert_non_null(tx_data);
+
+    context.data = tx_data;
+    context.length = tx_length;
+
+    assert_int_equal(parse_txn_context(&context), 0);
+    assert_int_equal(build_summary(&context.result, &summary), E_INVALID_DATA);
+    free(tx_data);
+}
+
 static void test_parse_transfer_transaction(void **state) {
     (void) state;
 
@@ -316,6 +360,355 @@ static void test_parse_multisig_cosignature_provision_namespace(void **state) {
     check_transaction_results("../testcases/multisig_cosignature_provision_namespace.raw", sizeof(expected) / sizeof(expected[0]), expected);
 }
 
+static void test_summary_transfer_transaction(void **state) {
+    (void) state;
+
+    const result_entry_t expected[3] = {
+        {"Transfer TX", "to TBE56Z7MLQZ4S755JZL46VRYM7OD37SLPGFZPO5O"},
+        {"Message", "ttest"},
+        {"Total", "5 XEM, fee 0.1 XEM"}
+    };
+
+    check_transaction_summary("../testcases/transfer_transaction.raw", sizeof(expected) / sizeof(expected[0]), expected);
+}
+
+static void test_summary_multisig_transfer_transaction(void **state) {
+    (void) state;
+
+    const result_entry_t expected[3] = {
+        {"Multisig TX", "Transfer TX to TB7IB6DSJKWBVQEK7PD7TWO66ECW5LY6SISM2CJJ"},
+        {"Message", "Send a transfer transaction from a multisig account using Ledger"},
+        {"Total", "10 XEM, fee 0.35 XEM"}
+    };
+
+    check_transaction_summary("../testcases/multisig_transfer_transaction.raw", sizeof(expected) / sizeof(expected[0]), expected);
+}
+
+static void test_summary_unavailable(void **state) {
+    (void) state;
+
+    // Mosaics other than XEM, long message, cosignature, other transaction types
+    check_no_summary("../testcases/transfer_transaction_multi_mosaics.raw");
+    check_no_summary("../testcases/transfer_transaction_long_message.raw");
+    check_no_summary("../testcases/multisig_cosignature_transfer_transaction.raw");
+    check_no_summary("../testcases/provision_subnamespace.raw");
+    check_no_summary("../testcases/mosaic_definition_with_levy.raw");
+}
+
+static void test_build_transfer_transaction(void **state) {
+    (void) state;
+    uint8_t buffer[256];
+    tx_builder_t builder;
+    const tx_header_t header = {
+        .version = 1,
+        .networkType = TESTNET,
+        .timestamp = 0x0a6905b0,
+        .signer = {0x9f, 0x96, 0xdf, 0x7e, 0x7a, 0x63, 0x9b, 0x40, 0x34, 0xb8, 0xbe, 0xe5, 0xb8, 0x8a, 0xb1, 0xd6,
+                   0x40, 0xdb, 0x66, 0xeb, 0x5a, 0x47, 0xaf, 0xe0, 0x18, 0xe3, 0x20, 0xcb, 0x13, 0x0c, 0x18, 0x3d},
+        .fee = 100000,
+        .deadline = 0x0a6913c0
+    };
+    const tx_transfer_t transfer = {
+        .recipient = "TBE56Z7MLQZ4S755JZL46VRYM7OD37SLPGFZPO5O",
+        .amount = 5000000,
+        .messageType = 1,
+        .message = (const uint8_t *) "ttest",
+        .messageLength = 5
+    };
+
+    size_t tx_length;
+    uint8_t * const tx_data = load_transaction_data("../testcases/transfer_transaction.raw", &tx_length);
+    tx_builder_init(&builder, buffer, sizeof(buffer));
+    tx_build_transfer(&builder, &header, &transfer);
+    assert_false(builder.overflow);
+    assert_int_equal(builder.length, tx_length);
+    assert_memory_equal(buffer, tx_data, tx_length);
+    free(tx_data);
+}
+
+static const field_t *find_field(const result_t *result, uint8_t id, bool last) {
+    const field_t *found = NULL;
+    for (uint8_t i = 0; i < result->numFields; i++) {
+        if (result->fields[i].id == id) {
+            found = &result->fields[i];
+            if (!last) {
+                break;
+            }
+        }
+    }
+    return found;
+}
+
+// The windows of a long message must add up to the whole message
+static void check_message_windows(const char *filename, const char *expected) {
+    parse_context_t context = {0};
+    char window[MAX_FIELD_LEN];
+    char *message = calloc(1, strlen(expected) + MAX_FIELD_LEN);
+
+    size_t tx_length;
+    uint8_t * const tx_data = load_transaction_data(filename, &tx_length);
+    context.data = tx_data;
+    context.length = tx_length;
+    assert_int_equal(parse_txn_context(&context), 0);
+
+    const field_t *field = find_field(&context.result, NEM_STR_TXN_MESSAGE, false);
+    assert_non_null(field);
+    uint8_t count = format_window_count(field);
+    assert_true(count > 1 && count <= MAX_MESSAGE_WINDOWS);
+    for (uint8_t i = 0; i < count; i++) {
+        format_field_window(&context.result, field, i, window);
+        assert_true(strlen(window) > 0 && strlen(window) <= MESSAGE_WINDOW_LEN);
+        strcat(message, window);
+    }
+    assert_string_equal(message, expected);
+    assert_int_equal(format_window_count(find_field(&context.result, NEM_UINT64_TXN_FEE, false)), 1);
+    free(message);
+    free(tx_data);
+}
+
+static void test_message_windows(void **state) {
+    (void) state;
+    char expected[512] = "";
+    while (strlen(expected) < 300) {
+        strcat(expected, "The quick brown fox jumps over the lazy dog. ");
+    }
+    check_message_windows("../testcases/transfer_transaction_long_message.raw", expected);
+
+    for (int i = 0; i < 250; i++) {
+        snprintf(expected + 2 * i, 3, "%02x", i);
+    }
+    check_message_windows("../testcases/transfer_transaction_long_hex_message.raw", expected);
+}
+
+// Nested lengths must match the objects they contain
+static void test_parse_inconsistent_lengths(void **state) {
+    (void) state;
+    size_t size;
+    uint8_t *tx_data = load_transaction_data("../testcases/mosaic_definition_with_levy.raw", &size);
+    // Mosaic definition length, after the common header
+    uint32_t offset = 60;
+    uint32_t length = read_uint32(tx_data + offset);
+
+    for (int delta = -1; delta <= 1; delta++) {
+        parse_context_t context = {0};
+        uint32_t value = length + delta;
+        memcpy(tx_data + offset, &value, sizeof(value));
+        context.data = tx_data;
+        context.length = size;
+        assert_int_equal(parse_txn_context(&context), delta == 0 ? E_SUCCESS : E_INVALID_DATA);
+    }
+    free(tx_data);
+}
+
+static void test_span_reads(void **state) {
+    (void) state;
+    const uint8_t data[] = {0xFF, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08};
+    uint32_t offset = 1;
+    span_t span;
+
+    // Values are read at odd addresses, little endian
+    assert_true(span_take(data, sizeof(data), &offset, 8, &span));
+    assert_int_equal(offset, 9);
+    assert_int_equal(span_uint16(&span, 0), 0x0201);
+    assert_int_equal(read_uint16(data + 1), 0x0201);
+    assert_int_equal(span_uint32(&span, 1), 0x05040302);
+    assert_true(span_uint64(&span, 0) == 0x0807060504030201ull);
+    span_t next = span_next(&span, 2);
+    assert_int_equal(span_uint16(&next, 0), 0x0201);
+    assert_int_equal(span.length, 6);
+    assert_int_equal(span_uint32(&span, 0), 0x06050403);
+
+    // Nothing is taken past the end, whatever the length
+    offset = 1;
+    assert_false(span_take(data, sizeof(data), &offset, 9, &span));
+    assert_false(span_take(data, sizeof(data), &offset, UINT32_MAX, &span));
+    assert_int_equal(offset, 1);
+    assert_true(span_take(data, sizeof(data), &offset, 0, &span));
+    assert_int_equal(offset, 1);
+}
+
+// Amounts shown for the mosaics of a transfer with a multiplier, separated by ", "
+static int format_scaled_mosaic_amounts(uint8_t networkType, uint64_t multiplier, const tx_mosaic_t *mosaics,
+                                        uint32_t numMosaics, char *amounts) {
+    uint8_t buffer[512];
+    char value[MAX_FIELD_LEN];
+    tx_builder_t builder;
+    parse_context_t context = {0};
+    const tx_header_t header = {.version = 2, .networkType = networkType, .fee = 150000};
+    const tx_transfer_t transfer = {
+        .recipient = "NALICE2A73DLYTP4365GNFCURAUP3XVBFO7YNYOW",
+        .amount = multiplier,
+        .messageType = 1,
+        .mosaics = mosaics,
+        .numMosaics = numMosaics
+    };
+
+    tx_builder_init(&builder, buffer, sizeof(buffer));
+    tx_build_transfer(&builder, &header, &transfer);
+    context.data = buffer;
+    context.length = builder.length;
+    context.networkType = networkType;
+    amounts[0] = '\0';
+    if (parse_txn_context(&context) != 0) {
+        return E_INVALID_DATA;
+    }
+    for (uint8_t i = 0; i < context.result.numFields; i++) {
+        const field_t *field = &context.result.fields[i];
+        if (field->id == NEM_MOSAIC_AMOUNT || field->id == NEM_MOSAIC_KNOWN_UNITS || field->id == NEM_MOSAIC_UNITS) {
+            format_field(&context.result, field, value);
+            strcat(amounts, amounts[0] == '\0' ? "" : ", ");
+            strcat(amounts, value);
+        }
+    }
+    return E_SUCCESS;
+}
+
+static void format_mosaic_amounts(uint8_t networkType, const tx_mosaic_t *mosaics, uint32_t numMosaics, char *amounts) {
+    assert_int_equal(format_scaled_mosaic_amounts(networkType, NEM_TRANSFER_MULTIPLIER_ONE, mosaics, numMosaics,
+                                                  amounts), E_SUCCESS);
+}
+
+static void test_known_mosaics(void **state) {
+    (void) state;
+    char amounts[4 * MAX_FIELD_LEN];
+
+    // Every mosaic is in the slot of its hash
+    for (uint8_t slot = 0; slot < KNOWN_MOSAIC_SLOTS; slot++) {
+        const known_mosaic_t *mosaic = get_known_mosaic(slot);
+        if (mosaic->namespaceId != NULL) {
+            assert_int_equal(strlen(mosaic->namespaceId), mosaic->namespaceLength);
+            assert_int_equal(strlen(mosaic->name), mosaic->nameLength);
+            assert_int_equal(mosaic_hash((const uint8_t *) mosaic->namespaceId, mosaic->namespaceLength,
+                                         (const uint8_t *) mosaic->name, mosaic->nameLength) % KNOWN_MOSAIC_SLOTS, slot);
+        }
+    }
+
+    const tx_mosaic_t mosaics[] = {
+        {"nem", "xem", 1500000},
+        {"dim", "token", 12345678},
+        {"breeze", "breeze-token", 42},
+        {"pacnem", "heart", 0},
+        {"dim", "tokens", 5}
+    };
+    format_mosaic_amounts(MAINNET, mosaics, 5, amounts);
+    assert_string_equal(amounts, "1.5 XEM, 12.345678 DIMTOK, 42 BREEZE, 0 PAC:HRT, 5");
+
+    // Mosaics of other networks are unknown, except xem
+    format_mosaic_amounts(TESTNET, mosaics, 2, amounts);
+    assert_string_equal(amounts, "1.5 XEM, 12345678");
+
+    // Names are compared with their length
+    const tx_mosaic_t prefixed[] = {{"nem", "xe", 1}, {"ne", "mxem", 2}};
+    format_mosaic_amounts(MAINNET, prefixed, 2, amounts);
+    assert_string_equal(amounts, "1, 2");
+
+    // Quantities are per 1.000000 of the transfer amount, rounded down like the network does
+    assert_int_equal(format_scaled_mosaic_amounts(MAINNET, 2500000, mosaics, 5, amounts), E_SUCCESS);
+    assert_string_equal(amounts, "3.75 XEM, 30.864195 DIMTOK, 105 BREEZE, 0 PAC:HRT, 12");
+    assert_int_equal(format_scaled_mosaic_amounts(MAINNET, 0, mosaics, 2, amounts), E_SUCCESS);
+    assert_string_equal(amounts, "0 XEM, 0 DIMTOK");
+    const tx_mosaic_t huge[] = {{"nem", "xem", UINT64_MAX / 2}};
+    assert_int_equal(format_scaled_mosaic_amounts(MAINNET, 2000000, huge, 1, amounts), E_SUCCESS);
+    assert_string_equal(amounts, "18446744073709.551614 XEM");
+    assert_int_equal(format_scaled_mosaic_amounts(MAINNET, 2000001, huge, 1, amounts), E_INVALID_DATA);
+}
+
+static void test_field_schema(void **state) {
+    (void) state;
+    result_t result = {0};
+    char field_name[MAX_FIELDNAME_LEN];
+    char field_value[MAX_FIELD_LEN];
+    uint32_t value = 3;
+    field_t field = {NEM_UINT32_LEVY_FEE_TYPE, STI_UINT32, sizeof(uint32_t), (const uint8_t *) &value};
+
+    resolve_fieldname(&field, field_name);
+    format_field(&result, &field, field_value);
+    assert_string_equal(field_name, "Levy Fee Type");
+    assert_string_equal(field_value, "Percentile");
+
+    field.id = NEM_UINT32_AM_RELATIVE_CHANGE;
+    format_field(&result, &field, field_value);
+    assert_string_equal(field_value, "3");
+    value = 0;
+    format_field(&result, &field, field_value);
+    assert_string_equal(field_value, "Not change");
+
+    field.id = NEM_UINT32_TRANSACTION_TYPE;
+    value = 0x9999;
+    format_field(&result, &field, field_value);
+    assert_string_equal(field_value, "Unknown");
+
+    // Ids are only known with the data type of the schema
+    field.dataType = STI_UINT64;
+    resolve_fieldname(&field, field_name);
+    format_field(&result, &field, field_value);
+    assert_string_equal(field_name, "Unknown Field");
+    assert_string_equal(field_value, "[Not implemented]");
+    field.id = 0xFF;
+    resolve_fieldname(&field, field_name);
+    assert_string_equal(field_name, "Unknown Field");
+}
+
+static void test_round_trip_generated_transactions(void **state) {
+    (void) state;
+    uint8_t buffer[MAX_RAW_TX];
+    char field_name[MAX_FIELDNAME_LEN];
+    char field_value[MAX_FIELD_LEN];
+    tx_generator_t generator;
+    tx_generator_init(&generator, 0x4e454d);
+
+    for (int n = 0; n < 10000; n++) {
+        parse_context_t context = {0};
+        tx_builder_t builder;
+        tx_generated_t generated;
+        summary_t summary;
+        const field_t *field;
+
+        tx_builder_init(&builder, buffer, sizeof(buffer));
+        tx_generate(&generator, &builder, &generated);
+        assert_false(builder.overflow);
+
+        context.data = buffer;
+        context.length = builder.length;
+        assert_int_equal(parse_txn_context(&context), 0);
+        assert_int_equal(context.offset, builder.length);
+        assert_int_equal(read_uint32(context.result.fields[0].data), generated.type);
+        for (int i = 0; i < context.result.numFields; i++) {
+            resolve_fieldname(&context.result.fields[i], field_name);
+            format_field(&context.result, &context.result.fields[i], field_value);
+            // Every field of the parser is in the schema
+            assert_int_not_equal(strcmp(field_name, "Unknown Field"), 0);
+            assert_int_not_equal(strcmp(field_value, "[Not implemented]"), 0);
+        }
+        // Only transfers, possibly from a multisig account, are summarized
+        if (build_summary(&context.result, &summary) == E_SUCCESS) {
+            assert_int_equal(generated.innerType != 0 ? generated.innerType : generated.type, NEM_TXN_TRANSFER);
+            assert_true(generated.type == NEM_TXN_TRANSFER || generated.type == NEM_TXN_MULTISIG);
+        }
+
+        if (generated.innerType != 0) {
+            field = find_field(&context.result, generated.type == NEM_TXN_MULTISIG ?
+                               NEM_UINT32_INNER_TRANSACTION_TYPE : NEM_UINT32_DETAIL_TRANSACTION_TYPE, false);
+            assert_non_null(field);
+            assert_int_equal(read_uint32(field->data), generated.innerType);
+            field = find_field(&context.result, NEM_UINT64_MULTISIG_FEE, false);
+            assert_non_null(field);
+            assert_true(read_uint64(field->data) == generated.fee);
+            field = find_field(&context.result, NEM_UINT64_TXN_FEE, true);
+            assert_true(read_uint64(field->data) == generated.innerFee);
+        } else {
+            field = find_field(&context.result, NEM_UINT64_TXN_FEE, true);
+            assert_non_null(field);
+            assert_true(read_uint64(field->data) == generated.fee);
+        }
+        field = find_field(&context.result, NEM_STR_RECIPIENT_ADDRESS, false);
+        assert_int_equal(field != NULL, generated.hasRecipient);
+        if (field != NULL) {
+            assert_memory_equal(field->data, generated.recipient, NEM_ADDRESS_LENGTH);
+        }
+    }
+}
+
 int main(void) {
     const struct CMUnitTest tests[] = {
         cmocka_unit_test(test_parse_transfer_transaction),
@@ -332,6 +725,16 @@ int main(void) {
         cmocka_unit_test(test_parse_multisig_mosaic_definition_with_levy),
         cmocka_unit_test(test_parse_multisig_cosignature_transfer_transaction),
         cmocka_unit_test(test_parse_multisig_cosignature_provision_namespace),
+        cmocka_unit_test(test_summary_transfer_transaction),
+        cmocka_unit_test(test_summary_multisig_transfer_transaction),
+        cmocka_unit_test(test_summary_unavailable),
+        cmocka_unit_test(test_build_transfer_transaction),
+        cmocka_unit_test(test_message_windows),
+        cmocka_unit_test(test_parse_inconsistent_lengths),
+        cmocka_unit_test(test_span_reads),
+        cmocka_unit_test(test_known_mosaics),
+        cmocka_unit_test(test_field_schema),
+        cmocka_unit_test(test_round_trip_generated_transactions),
     };
     return cmocka_run_group_tests(tests, NULL, NULL);
 }